@@ -0,0 +1,72 @@
+#include <benchmark/benchmark.h>
+#include <QLoggingCategory>
+#include "gameworld.h"
+#include "obstaclerenderer.h"
+#include "water.h"
+
+// 加载过程中的调试输出会淹没测试结果
+static void silenceLogs()
+{
+    QLoggingCategory::setFilterRules("*.debug=false");
+}
+
+static void BM_LoadSphereModel(benchmark::State& state, const char* relativePath)
+{
+    silenceLogs();
+    const QString path = QString(AQUASNAKE_SOURCE_DIR "/") + relativePath;
+    for(auto _ : state) {
+        if(!ObstacleRenderer::loadSphereModel(path)) {
+            state.SkipWithError("failed to load model");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_CAPTURE(BM_LoadSphereModel, tiny, "objs/spiky_sphere/spiky_sphere_tiny.obj")
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_LoadSphereModel, large, "objs/spiky_sphere/spiky_sphere_large.obj")
+    ->Unit(benchmark::kMillisecond);
+
+// 只测纹理数据的生成，不含上传，不需要GL上下文
+static void BM_WaterCausticTexture(benchmark::State& state)
+{
+    silenceLogs();
+    Water water(GameWorld::DEFAULT_AQUARIUM_SIZE);
+    const int texSize = static_cast<int>(state.range(0));
+    for(auto _ : state) {
+        std::vector<float> texels = water.buildCausticTexture(texSize);
+        benchmark::DoNotOptimize(texels.data());
+    }
+    state.SetItemsProcessed(state.iterations() * texSize * texSize);
+}
+BENCHMARK(BM_WaterCausticTexture)->Arg(128)->Arg(Water::CAUSTIC_TEXTURE_SIZE)->Unit(benchmark::kMillisecond);
+
+static void BM_WaterNormalTexture(benchmark::State& state)
+{
+    const int texSize = static_cast<int>(state.range(0));
+    for(auto _ : state) {
+        std::vector<unsigned char> texels = Water::buildWaterNormalTexture(texSize);
+        benchmark::DoNotOptimize(texels.data());
+    }
+    state.SetItemsProcessed(state.iterations() * texSize * texSize);
+}
+BENCHMARK(BM_WaterNormalTexture)->Arg(Water::NORMAL_TEXTURE_SIZE)->Arg(1024)->Unit(benchmark::kMillisecond);
+
+// 先运行一段时间使粒子池充满，再测量稳定状态下每帧的更新
+static void BM_WaterUpdateParticles(benchmark::State& state)
+{
+    silenceLogs();
+    Water water(GameWorld::DEFAULT_AQUARIUM_SIZE);
+    water.setSeed(1);
+    const float deltaTime = 1.0f / 62.5f;
+    glm::vec3 target(0.0f);
+    for(int i = 0; i < 200; ++i) {
+        water.updateWaterParticles(deltaTime, target);
+    }
+    for(auto _ : state) {
+        target.x += 10.0f;
+        water.updateWaterParticles(deltaTime, target);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_WaterUpdateParticles);
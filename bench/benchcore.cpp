@@ -0,0 +1,154 @@
+#include <benchmark/benchmark.h>
+#include <glm/gtc/constants.hpp>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <thread>
+#include "gameworld.h"
+#include "snakecore.h"
+#include "rng.h"
+
+// 螺旋线参数：每圈约1250步，相邻两圈相距约125，形成紧密但不自相交的线圈
+static const float HELIX_TURN_ANGLE = glm::two_pi<float>() / 1250.0f;
+static const float HELIX_PITCH_ANGLE = 0.01f;
+
+// 沿螺旋线移动直到蛇身有 segments 个采样点，结果按长度缓存，各项测试共用
+static SnakeCore& snakeOfLength(int segments)
+{
+    static std::map<int, std::unique_ptr<SnakeCore>> cache;
+    std::unique_ptr<SnakeCore>& snake = cache[segments];
+    if(!snake) {
+        snake.reset(new SnakeCore(0.0f, 0.0f, 0.0f));
+        snake->rotateAroundAxis(glm::vec3(0.0f, 0.0f, 1.0f), HELIX_PITCH_ANGLE);
+        while(static_cast<int>(snake->getBody().size()) < segments) {
+            snake->grow();
+            snake->rotateAroundAxis(glm::vec3(0.0f, 1.0f, 0.0f), HELIX_TURN_ANGLE);
+            snake->move();
+        }
+    }
+    return *snake;
+}
+
+static void BM_SnakeMove(benchmark::State& state)
+{
+    SnakeCore& snake = snakeOfLength(static_cast<int>(state.range(0)));
+    for(auto _ : state) {
+        snake.rotateAroundAxis(glm::vec3(0.0f, 1.0f, 0.0f), HELIX_TURN_ANGLE);
+        snake.move();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SnakeMove)->RangeMultiplier(10)->Range(10, 1000000);
+
+static void BM_SnakeCheckSelfCollision(benchmark::State& state)
+{
+    const SnakeCore& snake = snakeOfLength(static_cast<int>(state.range(0)));
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(snake.checkSelfCollision());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SnakeCheckSelfCollision)->RangeMultiplier(10)->Range(10, 1000000);
+
+// 查询点分布在蛇身所在的圆柱面附近，约一半落在蛇身占据的单元中
+static void BM_SnakeCheckCollision(benchmark::State& state)
+{
+    const SnakeCore& snake = snakeOfLength(static_cast<int>(state.range(0)));
+    const int QUERY_COUNT = 1024;
+    std::vector<glm::vec3> queries(QUERY_COUNT);
+    Rng rng(1, RngStream::WORLD);
+    const glm::vec3 head = snake.getHeadPosition();
+    const float radius = 1250.0f * snake.getMovementSpeed() / glm::two_pi<float>();
+    for(glm::vec3& query : queries) {
+        float angle = rng.nextFloat() * glm::two_pi<float>();
+        float height = rng.uniform(0.0f, head.y + 1.0f);
+        float r = radius + rng.uniform(-100.0f, 100.0f);
+        query = glm::vec3(r * std::sin(angle), height, r * std::cos(angle) - radius);
+    }
+
+    size_t i = 0;
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(snake.checkCollision(queries[i]));
+        i = (i + 1) % QUERY_COUNT;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SnakeCheckCollision)->RangeMultiplier(10)->Range(10, 1000000);
+
+// 从空场开始补足 range(0) 个食物，场上有 range(1) 个障碍物
+// range(2) 为 0 时不启动后台线程，候选全部就地生成；为 1 时计时前等后台线程把队列填满
+// 两种情况都不让后台线程与计时部分的开头竞争，结果不随线程调度波动
+static void BM_WorldSpawnFood(benchmark::State& state)
+{
+    GameWorld world;
+    world.setFoodCount(static_cast<int>(state.range(0)));
+    world.setObstacleCount(static_cast<int>(state.range(1)));
+    const bool prefilled = state.range(2) != 0;
+    world.setFoodQueueWorkerEnabled(prefilled);
+    uint64_t seed = 1;
+    for(auto _ : state) {
+        state.PauseTiming();
+        world.reset(seed++);
+        world.initObstacles(glm::vec3(0.0f));
+        while(prefilled && world.getQueuedFoodCount() < FoodSpawnQueue::CAPACITY) {
+            std::this_thread::yield();
+        }
+        state.ResumeTiming();
+
+        world.spawnFood();
+        benchmark::DoNotOptimize(world.getFoods().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_WorldSpawnFood)
+    ->ArgNames({"food", "obstacles", "prefilled"})
+    ->ArgsProduct({{10, 100, 1000}, {0, 100, 1000, 10000}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+// 蛇头在场内随机位置时的障碍物碰撞判定，场上有 range(0) 个障碍物
+static void BM_WorldCheckCollisions(benchmark::State& state)
+{
+    GameWorld world;
+    world.setObstacleCount(static_cast<int>(state.range(0)));
+    world.reset(1);
+    world.initObstacles(glm::vec3(0.0f));
+
+    const int SNAKE_COUNT = 256;
+    std::vector<std::unique_ptr<SnakeCore>> snakes;
+    Rng rng(1, RngStream::WORLD);
+    const float range = world.getAquariumSize() * 0.8f;
+    for(int i = 0; i < SNAKE_COUNT; ++i) {
+        snakes.emplace_back(new SnakeCore(rng.signedUnit() * range, rng.signedUnit() * range * 0.5f,
+                                          rng.signedUnit() * range));
+    }
+
+    size_t i = 0;
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(world.checkCollisions(*snakes[i]));
+        i = (i + 1) % SNAKE_COUNT;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_WorldCheckCollisions)->RangeMultiplier(10)->Range(100, 100000);
+
+// 场上有 range(0) 个食物时一个逻辑帧的开销，水族箱放大以容纳按最小间距放置的食物
+static void BM_WorldTickFood(benchmark::State& state)
+{
+    GameWorld world(40000.0f);
+    world.setFoodCount(static_cast<int>(state.range(0)));
+    world.setObstacleCount(0);
+    world.reset(1);
+    world.spawnFood();
+
+    SnakeCore snake(0.0f, 0.0f, 0.0f);
+    int steps = 0;
+    for(auto _ : state) {
+        // 在原点附近兜圈，避免撞墙后停止移动
+        if(++steps % 100 == 0) {
+            world.applyInput(snake, InputCommand::TURN_LEFT);
+        }
+        benchmark::DoNotOptimize(world.tick(snake));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_WorldTickFood)->RangeMultiplier(10)->Range(100, 100000);
@@ -0,0 +1,55 @@
+#ifndef CHUNKBOUNDS_H
+#define CHUNKBOUNDS_H
+
+#include <glm/glm.hpp>
+#include <deque>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "memorystats.h"
+
+class SnakeBody;
+
+// 按序号把连续的段分组（每组 CHUNK_SIZE 段），每组维护一个AABB
+// 每帧只有蛇头和蛇尾所在的组发生变化，只对标记为脏的组重新计算
+class ChunkBounds {
+public:
+    static constexpr uint64_t CHUNK_SHIFT = 5;
+    static constexpr uint64_t CHUNK_SIZE = uint64_t(1) << CHUNK_SHIFT;
+
+    struct Chunk {
+        glm::vec3 min;
+        glm::vec3 max;
+        uint64_t headSequence;  // 组内最靠近蛇头的段的序号
+        size_t count;           // 组内当前的段数
+        bool dirty;
+    };
+
+    ChunkBounds();
+
+    void clear();
+    void markDirty(uint64_t sequence);   // 段进入或离开时调用
+    void refit(const SnakeBody& body);   // 重新计算所有脏组，并移除空组
+
+    size_t chunkCount() const { return chunks.size(); }
+    MemoryUsage memoryUsage() const;
+
+    // 从蛇头到蛇尾依次访问每个组
+    template<typename Visitor>
+    void forEachChunk(Visitor visitor) const;
+
+private:
+    std::deque<Chunk> chunks;  // 下标0对应 firstChunk，即最靠近蛇尾的组
+    uint64_t firstChunk;
+    std::vector<uint64_t> dirtyChunks;  // 待重新计算的组编号，避免每帧扫描所有组
+};
+
+template<typename Visitor>
+void ChunkBounds::forEachChunk(Visitor visitor) const
+{
+    for(auto it = chunks.rbegin(); it != chunks.rend(); ++it) {
+        if(it->count > 0) visitor(*it);
+    }
+}
+
+#endif // CHUNKBOUNDS_H
@@ -0,0 +1,61 @@
+#ifndef FOODRENDERER_H
+#define FOODRENDERER_H
+
+#include <GL/glew.h>
+#include <QOpenGLFunctions>
+#include <glm/glm.hpp>
+#include <vector>
+#include "food.h"
+#include "memorystats.h"
+
+class QOpenGLContext;
+
+// 食物的绘制：每个食物是一个朝向相机的四边形，片段着色器对其中的球体求交，
+// 输出精确的深度和逐像素光照，所有食物一次实例化绘制完成
+// 不支持 OpenGL 3.3 或着色器编译失败时回退到立即模式的球体网格
+class FoodRenderer : protected QOpenGLFunctions {
+public:
+    FoodRenderer();
+    ~FoodRenderer();
+
+    // 需要当前GL上下文，重复调用时先释放旧的资源
+    void initializeGL();
+    void releaseGL();
+    bool isImpostorRendering() const { return program != 0; }
+
+    // 调用前设置好模型视图矩阵、光源和材质；revision 不变时不重新上传实例数据
+    void draw(const std::vector<Food>& foods, uint64_t revision);
+
+    void reportMemory(MemoryReport& report) const;
+
+private:
+    struct FoodInstance {
+        glm::vec3 position;
+        float radius;
+    };
+
+    GLuint buildProgram();
+    void setShadingUniforms();
+    void uploadInstances(const std::vector<Food>& foods, uint64_t revision);
+    void drawImmediate(const std::vector<Food>& foods);
+
+    static const char* vertexShader;
+    static const char* fragmentShader;
+
+    QOpenGLContext* glContext;        // 创建GL资源时的上下文
+    GLuint program;                   // 为0时回退到立即模式
+    GLuint cornerVBO;                 // 四边形的4个角，(±1, ±1)
+    GLuint instanceVBO;
+    std::vector<FoodInstance> instanceData;
+    uint64_t uploadedRevision;
+    bool uploaded;
+    size_t uploadedBytes;
+
+    static constexpr float FOOD_COLOR_R = 1.0f;   // 金黄色
+    static constexpr float FOOD_COLOR_G = 0.8f;
+    static constexpr float FOOD_COLOR_B = 0.0f;
+    static constexpr int FALLBACK_SPHERE_SECTORS = 16;
+    static constexpr int FALLBACK_SPHERE_STACKS = 16;
+};
+
+#endif // FOODRENDERER_H
@@ -0,0 +1,67 @@
+#ifndef FOODSPAWNQUEUE_H
+#define FOODSPAWNQUEUE_H
+
+#include <glm/glm.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "obstacle.h"
+#include "obstaclegrid.h"
+#include "rng.h"
+#include "memorystats.h"
+
+// 后台线程预先生成食物候选位置：在生成区域内均匀抽取，并排除落在障碍物内的点
+// 障碍物在一局内不变，可以提前检查；与已有食物的间距和蛇身占用随时变化，由取用方在取出时重新检查
+//
+// 候选序列只由种子决定：生成器状态由互斥锁保护，队列为空时取用方在锁内自己生成下一个，
+// 因此无论后台线程是否跟上，取出的第k个候选都相同，录制的输入可以逐位回放
+class FoodSpawnQueue {
+public:
+    FoodSpawnQueue();
+    ~FoodSpawnQueue();
+
+    FoodSpawnQueue(const FoodSpawnQueue&) = delete;
+    FoodSpawnQueue& operator=(const FoodSpawnQueue&) = delete;
+
+    // 停止旧的线程，以给定种子和障碍物重新配置并清空队列，不启动后台线程，之后 pop 就地生成
+    void reset(uint64_t seed, const glm::vec3& min, const glm::vec3& max, const std::vector<Obstacle>& obstacles);
+    // 同 reset，之后启动后台线程预先生成
+    void start(uint64_t seed, const glm::vec3& min, const glm::vec3& max, const std::vector<Obstacle>& obstacles);
+    void stop();
+
+    // 取出下一个候选，不会阻塞等待后台线程
+    // 连续 MAX_DARTS 次都落在障碍物内时该候选作废，返回 false
+    bool pop(glm::vec3& position);
+    size_t readyCount() const;
+    MemoryUsage memoryUsage() const;
+
+    static constexpr size_t CAPACITY = 1024;    // 后台线程最多提前生成的候选数
+    static constexpr int MAX_DARTS = 64;        // 单个候选的抽取上限，障碍物极密时放弃检查
+
+private:
+    struct Candidate {
+        glm::vec3 position;
+        bool valid;
+    };
+
+    void run();
+    Candidate generate();           // 调用时必须持有 mutex
+
+    mutable std::mutex mutex;
+    std::condition_variable spaceAvailable;
+    std::thread worker;
+    bool stopping;
+
+    // 以下成员由 mutex 保护
+    Rng rng;
+    glm::vec3 boundsMin;
+    glm::vec3 boundsMax;
+    std::vector<Obstacle> obstacles;    // 开始时的副本，世界重新放置障碍物时会重新 start
+    ObstacleGrid obstacleGrid;
+    std::deque<Candidate> ready;
+};
+
+#endif // FOODSPAWNQUEUE_H
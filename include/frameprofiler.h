@@ -0,0 +1,131 @@
+#ifndef FRAMEPROFILER_H
+#define FRAMEPROFILER_H
+
+#include <GL/glew.h>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "tracerecorder.h"
+
+// 逐帧统计各阶段的耗时：CPU 用 steady_clock 计时，GPU 用 GL_TIME_ELAPSED 查询
+// GPU 结果在数帧之后才可读，查询对象按 FRAME_LATENCY 帧轮换使用，不阻塞渲染
+// 逻辑帧阶段（updateGame、updateCamera）在 paintGL 之外执行，只有 CPU 时间
+class FrameProfiler {
+public:
+    enum Phase {
+        UPDATE_GAME = 0,
+        UPDATE_CAMERA,
+        UPDATE_LIGHTS,          // updateLights 与 applyLightSettings
+        DRAW_AQUARIUM,
+        DRAW_SCENE_OBJECTS,
+        WATER_RENDER,
+        WATER_UNDERWATER,       // Water::renderUnderwaterEffects
+        WATER_PARTICLES,        // paintGL 中单独调用的 renderWaterParticles
+        PHASE_COUNT
+    };
+
+    struct Stats {
+        float cpuAverage;       // 毫秒
+        float cpuP99;
+        float gpuAverage;       // 不支持计时查询时为0
+        float gpuP99;
+    };
+
+    FrameProfiler();
+    ~FrameProfiler();
+
+    static const char* phaseName(Phase phase);
+
+    // 需要当前GL上下文
+    void initializeGL();
+    void releaseGL();
+    bool hasGpuTimers() const { return gpuTimers; }
+
+    void setEnabled(bool enable);
+    bool isEnabled() const { return enabled; }
+
+    // 每帧一行：帧号、帧间隔和各阶段的 CPU/GPU 毫秒数
+    bool openCsv(const std::string& path);
+    void closeCsv();
+
+    // 包住 paintGL，其间的阶段同时发起 GPU 查询
+    void beginFrame();
+    void endFrame();
+
+    void beginPhase(Phase phase);
+    void endPhase(Phase phase);
+
+    Stats getStats(Phase phase) const;
+    float getFrameAverage() const;
+    float getFrameP99() const;
+
+private:
+    struct FrameRecord {
+        uint64_t frame;
+        float frameTime;
+        float cpu[PHASE_COUNT];
+        float gpu[PHASE_COUNT];
+        bool queried[PHASE_COUNT];  // 本帧是否发起了该阶段的 GPU 查询
+        bool pending;               // 等待 GPU 结果
+    };
+
+    void resolveFrame(FrameRecord& record, bool wait);
+    void finishFrame(const FrameRecord& record);
+    static float average(const std::vector<float>& history, size_t count);
+    static float percentile99(const std::vector<float>& history, size_t count);
+
+    static constexpr size_t FRAME_LATENCY = 4;    // GPU 结果最多滞后的帧数
+    static constexpr size_t HISTORY_SIZE = 240;   // 滚动统计的帧数
+
+    bool enabled;
+    bool gpuTimers;
+    bool inFrame;
+    int activeQuery;                          // 正在计时的阶段，GL_TIME_ELAPSED 查询不能嵌套
+    uint64_t frameIndex;
+    std::chrono::steady_clock::time_point lastFrameStart;
+    std::chrono::steady_clock::time_point phaseStart[PHASE_COUNT];
+
+    FrameRecord current;
+    FrameRecord inFlight[FRAME_LATENCY];
+    GLuint queries[FRAME_LATENCY][PHASE_COUNT];
+
+    // 环形缓冲区，historyCount 为已填充的帧数
+    std::vector<float> cpuHistory[PHASE_COUNT];
+    std::vector<float> gpuHistory[PHASE_COUNT];
+    std::vector<float> frameHistory;
+    size_t historyCursor;
+    size_t historyCount;
+
+    std::ofstream csv;
+};
+
+// 作用域计时，profiler 关闭时阶段计时只有一次分支的开销
+// 同时向 TraceRecorder 写入一条 phase 分类的时间线事件；追踪默认开启，
+// 因此即使 profiler 关闭，每个作用域仍有两次 steady_clock 读取和一次原子 fetch_add，
+// 关闭 TraceRecorder 后这部分也只剩一次分支
+class ProfileScope {
+public:
+    ProfileScope(FrameProfiler& profiler, FrameProfiler::Phase phase)
+        : profiler(profiler), phase(phase), active(profiler.isEnabled())
+        , trace("phase", FrameProfiler::phaseName(phase))
+    {
+        if(active) profiler.beginPhase(phase);
+    }
+    ~ProfileScope()
+    {
+        if(active) profiler.endPhase(phase);
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    FrameProfiler& profiler;
+    FrameProfiler::Phase phase;
+    bool active;
+    TraceScope trace;
+};
+
+#endif // FRAMEPROFILER_H
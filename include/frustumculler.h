@@ -0,0 +1,42 @@
+#ifndef FRUSTUMCULLER_H
+#define FRUSTUMCULLER_H
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// 批量球体视锥剔除
+// 输入为SoA布局的球心坐标，使用SSE2每次测试4个球（编译开启AVX时为8个），
+// 不支持SIMD的平台回退到标量实现；输出压缩后的可见下标列表
+class FrustumCuller {
+public:
+    FrustumCuller();
+
+    // 平面需已归一化，法线指向视锥体内部
+    void setPlanes(const glm::vec4 planes[6]);
+
+    // 测试 count 个半径相同的球，可见球的下标（firstIndex + i）追加到 visible 末尾
+    // 返回追加的数量
+    size_t cull(const float* xs, const float* ys, const float* zs, size_t count,
+                float radius, uint32_t firstIndex, std::vector<uint32_t>& visible) const;
+
+    bool isSphereVisible(const glm::vec3& center, float radius) const;
+
+    enum Containment { OUTSIDE, INTERSECTING, INSIDE };
+
+    // 判断中心位于AABB内、半径为radius的所有球相对视锥体的位置
+    Containment classifyBox(const glm::vec3& boxMin, const glm::vec3& boxMax, float radius) const;
+
+private:
+    size_t cullScalar(const float* xs, const float* ys, const float* zs, size_t begin, size_t count,
+                      float radius, uint32_t firstIndex, uint32_t* out) const;
+
+    // 每个平面的系数按分量分开存放，便于广播到SIMD寄存器
+    float planeX[6];
+    float planeY[6];
+    float planeZ[6];
+    float planeW[6];
+};
+
+#endif // FRUSTUMCULLER_H
@@ -7,16 +7,21 @@
 #include <QOpenGLWidget>
 #include <QOpenGLFunctions>
 #include <QTimer>
+#include <QElapsedTimer>
+#include <QString>
 #include <glm/glm.hpp>  
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>  
 #include "snake.h"
-#include "obstacle.h"
-#include "food.h"
+#include "gameworld.h"
 #include "water.h"  
+#include "frameprofiler.h"
+#include "foodrenderer.h"
+#include "simulationconfig.h"
 
 // 前向声明
 class MenuWidget;
+class RenderBenchmark;
 
 class GameWidget : public QOpenGLWidget, protected QOpenGLFunctions
 {
@@ -24,6 +29,7 @@ class GameWidget : public QOpenGLWidget, protected QOpenGLFunctions
 
     // 添加友元类声明
     friend class MenuWidget;
+    friend class RenderBenchmark;   // 离屏基准测试直接驱动相机和 paintGL
 
 public:
     explicit GameWidget(QWidget *parent = nullptr);
@@ -31,9 +37,40 @@ public:
     void resetGame();
     void pauseGame();
     void resumeGame();
-    int getScore() const { return score; }
-    int getSnakeLength() const { return snake ? snake->getBody().size() : 3; }
+    int getScore() const { return world.getScore(); }
+    int getSnakeLength() const { return snake ? snake->getLength() : 3; }
     bool isGamePaused() const { return gameState == GameState::PAUSED; }
+
+    // 逻辑帧率（每秒固定步数）与渲染帧率上限，0表示跟随显示器刷新
+    void setTickRate(float ticksPerSecond);
+    float getTickRate() const { return tickRate; }
+    void setFrameRateLimit(int fps);
+    int getFrameRateLimit() const { return frameRateLimit; }
+
+    // 输入录制与回放：录制从调用时开始新的一局，回放从日志的初始种子开始
+    // 回放期间键盘的转向和重置输入被忽略，重置游戏会从头重新回放
+    bool startRecording(const QString& path);
+    bool startReplay(const QString& path);
+    bool isReplaying() const { return replaying; }
+
+    // 逐阶段性能统计（F3 切换），开启 CSV 输出时同时开启统计
+    void setProfilerEnabled(bool enable);
+    bool isProfilerEnabled() const { return profiler.isEnabled(); }
+    bool startProfilerCsv(const QString& path);
+
+    // 把最近 traceWindowSeconds 秒的时间线事件写入当前目录（F5），返回文件名，失败时为空
+    QString saveTrace();
+    void setTraceWindow(double seconds) { traceWindowSeconds = seconds; }
+
+    // 本实例的蛇、食物、障碍物和水体占用的内存（F4 切换调试面板）
+    void reportMemory(MemoryReport& report) const;
+    void setMemoryOverlayEnabled(bool enable);
+    bool isMemoryOverlayEnabled() const { return memoryOverlay; }
+
+    // 规模参数（水族箱大小、食物和障碍物数量、粒子上限、初始蛇长）
+    // 须在创建 GameWidget 之前设置，对之后创建的实例生效
+    static void setSimulationConfig(const SimulationConfig& config) { simulationConfig = config; }
+    static const SimulationConfig& getSimulationConfig() { return simulationConfig; }
     
     // 添加访问器方法
     float getAquariumSize() const { return aquariumSize; }
@@ -46,22 +83,29 @@ signals:
     void scoreChanged(int newScore);
     void lengthChanged(int newLength);
     void gameOver();
+    void profilerToggled(bool enabled);
+    void profilerReport(const QString& text);   // 约每0.5秒一次的滚动统计
+    void memoryOverlayToggled(bool enabled);
 
 protected:
     void initializeGL() override;
     void resizeGL(int w, int h) override;
     void paintGL() override;
     void keyPressEvent(QKeyEvent *event) override;
-    void timerEvent(QTimerEvent *event) override;
 
 private:
     void initShaders();
     void createAquarium();
     void drawAquarium();
     void updateGame();
-    void spawnFood();
+    void resetSimulation(uint64_t seed);  // 以给定种子重建蛇、障碍物和食物
+    void applyInputs();                   // 在逻辑帧边界应用排队的输入或回放日志中的命令
+    static uint64_t makeSeed();
     void updateCamera();     // 更新摄像机位置
-    bool isInAquarium(const glm::vec3& pos) const;  
+    void advanceFrame();     // 按真实时间推进固定步长逻辑帧，然后请求重绘
+    void applyRenderInterpolation();
+    void restartFrameClock();
+    int timerInterval() const;
 
     QTimer* gameTimer;
     float rotationAngle;
@@ -74,9 +118,8 @@ private:
     glm::mat4 viewMatrix;
     float aquariumSize;
     bool isGameOver;  // 改名以避免与信号冲突
-    std::vector<Obstacle> obstacles;
-    void initObstacles();
-    void checkCollisions();
+    GameWorld world;      // 蛇以外的游戏状态与规则：食物、障碍物、分数、无敌帧
+    FoodRenderer foodRenderer;
     float waterLevel;
     GLuint waterShader;
     void initWaterEffect();
@@ -85,12 +128,7 @@ private:
     const float CAMERA_DEFAULT_ANGLE = -30.0f;  
     const float DEFAULT_CAMERA_DISTANCE = -20.0f;
     const float DEFAULT_CAMERA_HEIGHT = 15.0f;
-    const float AQUARIUM_DEFAULT_SIZE = 5000.0f;
     const float SEGMENT_SIZE = 100.0f;
-    const float MIN_FOOD_DISTANCE = 400.0f;
-    const int MAX_OBSTACLES = 100;
-    const int MIN_FOOD_COUNT = 100;
-    std::vector<Food> foods;
 
     enum class GameState {
         READY = 0,
@@ -100,16 +138,11 @@ private:
     };
     
     GameState gameState;
-    int score;
-    bool isValidFoodPosition(const glm::vec3& pos) const;
     
     // 相机插值参数
     glm::vec3 targetCameraPos;
     glm::vec3 targetCameraTarget;
     static constexpr float CAMERA_SMOOTH_FACTOR = 0.1f;
-    
-    // 添加无敌帧相关变量
-    int invincibleFrames = 0;  // 当前的无敌帧计数
 
     // 相机设置优化
     struct CameraSettings {
@@ -160,7 +193,37 @@ private:
 
     // 保留必要的水体相关变量
     Water* water;  
-    float deltaTime;
+    float deltaTime;                  // 固定逻辑步长，等于 1 / tickRate
+
+    // 固定步长主循环
+    QElapsedTimer frameClock;
+    double tickAccumulator;           // 尚未消耗的真实时间（秒）
+    float tickRate;
+    int frameRateLimit;
+    float renderAlpha;                // 当前渲染时刻在两个逻辑帧之间的位置
+    glm::vec3 renderCameraPos;        // 插值后的相机位置，与 viewMatrix 一致，绘制时据此判断是否在水下
+    glm::vec3 previousCameraPos;      // 上一逻辑帧的相机状态，用于插值
+    glm::vec3 previousCameraTarget;
+    glm::quat previousCameraRotation;
+    static constexpr float DEFAULT_TICK_RATE = 62.5f;   // 与原先16ms一帧的游戏速度一致
+    static constexpr double MAX_FRAME_TIME = 0.25;      // 单帧最多追赶的时间，避免卡顿后连续追帧
+
+    // 输入在按键时排队，下一个逻辑帧开始前生效，使录制的帧编号与效果一致
+    uint64_t tickCount;               // 已执行的逻辑帧数
+    std::vector<InputCommand> pendingInputs;
+    InputRecorder recorder;
+    InputLog replayLog;
+    size_t replayCursor;
+    bool replaying;
+
+    static SimulationConfig simulationConfig;
+    bool memoryOverlay = false;
+    double traceWindowSeconds = 10.0;
+
+    FrameProfiler profiler;
+    QElapsedTimer profilerReportClock;
+    static constexpr int PROFILER_REPORT_INTERVAL = 500;  // 毫秒
+    QString profilerReportText() const;
 
     // 着色器源码
     static const char* volumetricLightVertexShader;   // 体积顶点着色器
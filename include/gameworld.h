@@ -0,0 +1,106 @@
+#ifndef GAMEWORLD_H
+#define GAMEWORLD_H
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+#include "snakecore.h"
+#include "rng.h"
+#include "inputlog.h"
+#include "obstacle.h"
+#include "obstaclegrid.h"
+#include "poissondisksampler.h"
+#include "foodspawnqueue.h"
+#include "food.h"
+#include "memorystats.h"
+
+// 游戏规则与场景状态：食物生成、障碍物放置、进食与碰撞判定
+// 不依赖Qt和OpenGL，GameWidget 与无界面的模拟程序共用
+class GameWorld {
+public:
+    enum class Collision {
+        NONE,
+        OBSTACLE,
+        SELF
+    };
+
+    // 一个逻辑帧的结果，由调用方据此更新界面和特效
+    struct TickResult {
+        bool moved = false;                    // 下一步会出界时蛇停在原地
+        int foodEaten = 0;
+        Collision collision = Collision::NONE;
+    };
+
+    explicit GameWorld(float aquariumSize = DEFAULT_AQUARIUM_SIZE);
+
+    // 以给定种子开始新的一局：清空食物和障碍物，清零分数和无敌帧
+    // 之后的所有随机结果只由种子和输入决定，录制的输入可以逐位复现
+    void reset(uint64_t seed);
+    TickResult tick(SnakeCore& snake);              // 推进一个逻辑帧
+    void applyInput(SnakeCore& snake, InputCommand command) const;  // 转向命令，在逻辑帧之间调用
+    // 补足食物数量：先取后台预生成的候选，重新检查间距和蛇身占用，都不合格时再就地采样
+    // 某个食物就地尝试 MAX_FOOD_ATTEMPTS 次仍失败时停止；snake 为空时不检查蛇身
+    void spawnFood(const SnakeCore* snake = nullptr);
+    void initObstacles(const glm::vec3& avoid);     // 重新放置障碍物，避开给定位置附近
+    Collision checkCollisions(const SnakeCore& snake) const;
+
+    bool isInAquarium(const glm::vec3& pos) const;
+    bool isValidFoodPosition(const glm::vec3& pos, const SnakeCore& snake) const;
+    bool isInsideObstacle(const glm::vec3& pos) const;
+
+    // 尖刺球模型不可用时只放置立方体障碍物
+    void setSpikyObstaclesEnabled(bool enabled) { spikyObstaclesEnabled = enabled; }
+    // 关闭后 initObstacles 不启动后台线程，候选全部由 spawnFood 就地生成，结果不变
+    void setFoodQueueWorkerEnabled(bool enabled) { foodQueueWorkerEnabled = enabled; }
+    size_t getQueuedFoodCount() const { return foodQueue.readyCount(); }   // 已预生成的候选数
+
+    // 场上维持的食物数量与每局放置的障碍物数量，下次生成时生效
+    void setFoodCount(int count) { foodCount = count > 0 ? count : 0; }
+    void setObstacleCount(int count) { obstacleCount = count > 0 ? count : 0; }
+    int getFoodCount() const { return foodCount; }
+    int getObstacleCount() const { return obstacleCount; }
+
+    float getAquariumSize() const { return aquariumSize; }
+    int getScore() const { return score; }
+    int getInvincibleFrames() const { return invincibleFrames; }
+    uint64_t getSeed() const { return seed; }
+    const std::vector<Food>& getFoods() const { return foods; }
+    uint64_t getFoodRevision() const { return foodRevision; }   // 食物增减时递增，渲染据此决定是否重新上传
+    const std::vector<Obstacle>& getObstacles() const { return obstacles; }
+    const ObstacleGrid& getObstacleGrid() const { return obstacleGrid; }
+    void reportMemory(MemoryReport& report) const;
+
+    static constexpr float DEFAULT_AQUARIUM_SIZE = 5000.0f;
+    static constexpr float MIN_FOOD_DISTANCE = 400.0f;
+    static constexpr int MAX_OBSTACLES = 100;
+    static constexpr int MIN_FOOD_COUNT = 100;
+    static constexpr int MAX_FOOD_ATTEMPTS = 1000;    // 单个食物的候选点上限
+    static constexpr int QUEUED_FOOD_ATTEMPTS = 16;   // 单个食物最多取用的预生成候选数
+    static constexpr float OBSTACLE_SIZE = 50.0f;
+    static constexpr int INVINCIBLE_FRAMES_AFTER_FOOD = 20;     // 吃到食物后的无敌帧数
+    static constexpr float FOOD_COLLISION_MULTIPLIER = 2.5f;    // 食物碰撞范围倍数
+    static constexpr float OBSTACLE_COLLISION_MULTIPLIER = 0.7f; // 障碍物碰撞范围倍数
+
+private:
+    void restartFoodQueue(bool startWorker);
+
+    float aquariumSize;
+    uint64_t seed;
+    Rng rng;                // 独立的 WORLD 流，不与渲染等其他调用者交错
+    std::vector<Food> foods;
+    uint64_t foodRevision;   // 只增不减，新的一局也不归零
+    // 与 foods 同序同步（都用交换弹出移除），既保证食物间距，也作为进食判定的空间索引
+    PoissonDiskSampler foodSampler;
+    std::vector<size_t> eatenFoods;  // tick 中复用的临时数组
+    FoodSpawnQueue foodQueue;        // reset 时重新播种，initObstacles 时以放置好的障碍物启动后台线程
+    std::vector<Obstacle> obstacles;
+    ObstacleGrid obstacleGrid;  // initObstacles 放置完成后构建，碰撞与食物生成共用
+    int score;
+    int invincibleFrames;   // 当前的无敌帧计数
+    int foodCount;
+    int obstacleCount;
+    bool spikyObstaclesEnabled;
+    bool foodQueueWorkerEnabled;
+};
+
+#endif // GAMEWORLD_H
@@ -0,0 +1,90 @@
+#ifndef INPUTLOG_H
+#define INPUTLOG_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// 影响模拟结果的输入命令，视角切换等只影响渲染的按键不记录
+enum class InputCommand : uint8_t {
+    TURN_UP = 0,     // W
+    TURN_DOWN = 1,   // S
+    TURN_LEFT = 2,   // A
+    TURN_RIGHT = 3,  // D
+    RESET = 4,       // R，附带新一局的随机种子
+    END = 5          // 录制结束的逻辑帧
+};
+
+// 改变模拟结果的规模参数，录制时写入日志头部，回放时必须与录制时一致
+struct SimulationScale {
+    float aquariumSize;
+    uint32_t obstacleCount;
+    uint32_t foodCount;
+    uint32_t snakeLength;
+
+    bool operator==(const SimulationScale& other) const {
+        return aquariumSize == other.aquariumSize && obstacleCount == other.obstacleCount &&
+               foodCount == other.foodCount && snakeLength == other.snakeLength;
+    }
+    bool operator!=(const SimulationScale& other) const { return !(*this == other); }
+};
+
+// 输入日志：以逻辑帧编号标记的命令序列，加上开局的随机种子和规模参数
+// 文件格式：
+//   头部  "AQSR" | uint16 版本 | float 逻辑帧率 | uint64 初始种子 |
+//         float 水族箱大小 | uint32 障碍物数 | uint32 食物数 | uint32 蛇长
+//   记录  varint 与上一条记录的帧差 | uint8 命令 | RESET 时另有 uint64 种子
+// 所有整数按小端序存储
+// 版本不同的日志拒绝回放：
+//   版本2  GameWorld 改用 PCG32 随机数流
+//   版本3  食物改用泊松圆盘采样
+//   版本4  食物候选改由 FOOD_SPAWN 流预生成
+//   版本5  头部记录规模参数
+class InputLog {
+public:
+    struct Entry {
+        uint64_t tick;          // 在该逻辑帧执行之前生效
+        InputCommand command;
+        uint64_t seed;          // 仅 RESET 使用
+    };
+
+    InputLog();
+
+    bool load(const std::string& path);
+
+    uint64_t getInitialSeed() const { return initialSeed; }
+    float getTickRate() const { return tickRate; }
+    const SimulationScale& getScale() const { return scale; }
+    const std::vector<Entry>& getEntries() const { return entries; }
+    uint64_t getEndTick() const { return endTick; }
+
+private:
+    uint64_t initialSeed;
+    float tickRate;
+    SimulationScale scale;
+    uint64_t endTick;
+    std::vector<Entry> entries;
+};
+
+// 边运行边写入输入日志，每条命令立即落盘，进程异常退出时已录制的部分仍可回放
+class InputRecorder {
+public:
+    InputRecorder();
+    ~InputRecorder();
+
+    bool open(const std::string& path, uint64_t initialSeed, float tickRate, const SimulationScale& scale);
+    bool isOpen() const { return file.is_open(); }
+    void record(uint64_t tick, InputCommand command, uint64_t seed = 0);
+    void close(uint64_t endTick);   // 写入 END 记录
+
+private:
+    void writeVarint(uint64_t value);
+    void writeU32(uint32_t value);
+    void writeU64(uint64_t value);
+
+    std::ofstream file;
+    uint64_t lastTick;
+};
+
+#endif // INPUTLOG_H
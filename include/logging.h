@@ -0,0 +1,82 @@
+#ifndef LOGGING_H
+#define LOGGING_H
+
+#include <QLoggingCategory>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// 日志分类，运行时可用 QT_LOGGING_RULES 或 --log-rules 按分类开关，例如
+//   aquasnake.water.particles.debug=false
+Q_DECLARE_LOGGING_CATEGORY(lcGame)        // aquasnake.game
+Q_DECLARE_LOGGING_CATEGORY(lcWater)       // aquasnake.water
+Q_DECLARE_LOGGING_CATEGORY(lcParticles)   // aquasnake.water.particles
+Q_DECLARE_LOGGING_CATEGORY(lcBubbles)     // aquasnake.water.bubbles
+
+// 编译期最低日志级别，低于该级别的调用在编译时即被消除
+#define AQ_LOG_LEVEL_DEBUG 0
+#define AQ_LOG_LEVEL_INFO 1
+#define AQ_LOG_LEVEL_WARNING 2
+#define AQ_LOG_LEVEL_CRITICAL 3
+#define AQ_LOG_LEVEL_OFF 4
+
+#ifndef AQUASNAKE_LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define AQUASNAKE_LOG_MIN_LEVEL AQ_LOG_LEVEL_WARNING
+#else
+#define AQUASNAKE_LOG_MIN_LEVEL AQ_LOG_LEVEL_DEBUG
+#endif
+#endif
+
+#define AQ_LOG_STREAM_DEBUG qCDebug
+#define AQ_LOG_STREAM_INFO qCInfo
+#define AQ_LOG_STREAM_WARNING qCWarning
+#define AQ_LOG_STREAM_CRITICAL qCCritical
+
+#define AQ_LOG_TYPE_DEBUG QtDebugMsg
+#define AQ_LOG_TYPE_INFO QtInfoMsg
+#define AQ_LOG_TYPE_WARNING QtWarningMsg
+#define AQ_LOG_TYPE_CRITICAL QtCriticalMsg
+
+#define AQ_LOG_COMPILED(level) (AQ_LOG_LEVEL_##level >= AQUASNAKE_LOG_MIN_LEVEL)
+
+// 输出语句中的参数只在日志真正输出时求值，可以放入开销较大的统计
+// AQ_LOG(DEBUG, lcWater) << "...";
+#define AQ_LOG(level, category) \
+    for(bool aqLogOn = AQ_LOG_COMPILED(level); aqLogOn; aqLogOn = false) \
+        AQ_LOG_STREAM_##level(category)
+
+// 每个调用点第1、n+1、2n+1……次执行时输出，用于每帧执行的代码
+#define AQ_LOG_EVERY_N(level, category, n) \
+    for(bool aqLogOn = AQ_LOG_COMPILED(level) && category().isEnabled(AQ_LOG_TYPE_##level) \
+            && [&] { static std::atomic<uint32_t> calls(0); \
+                    return calls.fetch_add(1, std::memory_order_relaxed) % (n) == 0; }(); \
+        aqLogOn; aqLogOn = false) \
+        AQ_LOG_STREAM_##level(category)
+
+// 每个调用点每 intervalMs 毫秒最多输出一次
+#define AQ_LOG_RATE_LIMITED(level, category, intervalMs) \
+    for(bool aqLogOn = AQ_LOG_COMPILED(level) && category().isEnabled(AQ_LOG_TYPE_##level) \
+            && [&] { static std::atomic<int64_t> last(INT64_MIN); \
+                    return Logging::rateLimit(last, intervalMs); }(); \
+        aqLogOn; aqLogOn = false) \
+        AQ_LOG_STREAM_##level(category)
+
+#define AQ_DEBUG(category) AQ_LOG(DEBUG, category)
+#define AQ_INFO(category) AQ_LOG(INFO, category)
+#define AQ_WARNING(category) AQ_LOG(WARNING, category)
+#define AQ_CRITICAL(category) AQ_LOG(CRITICAL, category)
+
+namespace Logging {
+    // 距上次输出已超过 intervalMs 时更新时间戳并返回 true
+    inline bool rateLimit(std::atomic<int64_t>& last, int64_t intervalMs)
+    {
+        int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        int64_t previous = last.load(std::memory_order_relaxed);
+        if(previous != INT64_MIN && now - previous < intervalMs) return false;
+        return last.compare_exchange_strong(previous, now, std::memory_order_relaxed);
+    }
+}
+
+#endif // LOGGING_H
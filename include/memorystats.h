@@ -0,0 +1,70 @@
+#ifndef MEMORYSTATS_H
+#define MEMORYSTATS_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// 内存占用：size 为存放有效数据的字节数，capacity 为实际分配的字节数
+// GPU 资源按上传的数据量估算，二者相同
+struct MemoryUsage {
+    size_t size = 0;
+    size_t capacity = 0;
+
+    MemoryUsage& operator+=(const MemoryUsage& other)
+    {
+        size += other.size;
+        capacity += other.capacity;
+        return *this;
+    }
+};
+
+template<typename T>
+MemoryUsage vectorMemory(const std::vector<T>& v)
+{
+    MemoryUsage usage;
+    usage.size = v.size() * sizeof(T);
+    usage.capacity = v.capacity() * sizeof(T);
+    return usage;
+}
+
+inline MemoryUsage gpuMemory(size_t bytes)
+{
+    MemoryUsage usage;
+    usage.size = usage.capacity = bytes;
+    return usage;
+}
+
+// 纹理字节数，完整的 mipmap 链约为基础层的 4/3
+inline size_t textureBytes(int width, int height, int bytesPerTexel, bool mipmapped = false)
+{
+    size_t bytes = static_cast<size_t>(width) * height * bytesPerTexel;
+    return mipmapped ? bytes + bytes / 3 : bytes;
+}
+
+// 按子系统汇总的内存报告，名称以点分隔层级，例如 snake.body、gpu.water.caustic_texture
+// 各子系统在 reportMemory 中按需即时统计，不在分配路径上维护计数器
+class MemoryReport {
+public:
+    struct Entry {
+        std::string name;
+        MemoryUsage usage;
+    };
+
+    void add(const std::string& name, const MemoryUsage& usage);
+    void append(const std::string& prefix, const MemoryReport& other);  // 合并另一份报告，名称加前缀
+
+    const std::vector<Entry>& getEntries() const { return entries; }
+    MemoryUsage total() const;
+
+    std::string toText() const;     // 调试面板用的对齐文本
+    std::string toJson() const;
+    bool writeJson(const std::string& path) const;
+
+    static std::string formatBytes(size_t bytes);
+
+private:
+    std::vector<Entry> entries;
+};
+
+#endif // MEMORYSTATS_H
@@ -0,0 +1,82 @@
+#ifndef OBSTACLEGRID_H
+#define OBSTACLEGRID_H
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include "obstacle.h"
+#include "memorystats.h"
+
+// 障碍物的静态均匀网格，放置障碍物后一次性构建，之后只读
+// 每个障碍物按其包围盒登记到所有重叠的单元，单元内容连续存放（前缀和偏移 + 下标数组）
+// 查询只访问与查询球包围盒重叠的单元，代价与障碍物总数无关
+class ObstacleGrid {
+public:
+    ObstacleGrid();
+
+    void build(const std::vector<Obstacle>& obstacles);
+    void clear();
+
+    size_t cellCount() const { return cellStart.empty() ? 0 : cellStart.size() - 1; }
+    float getCellSize() const { return cellSize; }
+    MemoryUsage memoryUsage() const;
+
+    // 障碍物碰撞形状的包围半径：立方体半对角线与尖刺球碰撞半径都不超过 size
+    static float boundingRadius(const Obstacle& obstacle) { return obstacle.getRadius(); }
+
+    // 遍历包围盒与以center为球心、radius为半径的球的包围盒重叠的障碍物下标
+    // 跨越多个单元的障碍物可能被访问多次，visitor(uint32_t) 返回true时提前结束，函数也返回true
+    template<typename Visitor>
+    bool visit(const glm::vec3& center, float radius, Visitor visitor) const;
+
+    static constexpr size_t MAX_CELLS = size_t(1) << 20;  // 单元数上限，超过时放大单元边长
+
+private:
+    int cellCoord(float v, int axis) const;
+    size_t cellIndex(int x, int y, int z) const { return (static_cast<size_t>(z) * dims[1] + y) * dims[0] + x; }
+
+    glm::vec3 origin;
+    float cellSize;
+    float invCellSize;
+    int dims[3];                      // 各轴单元数
+    std::vector<uint32_t> cellStart;  // 单元i的障碍物为 items[cellStart[i], cellStart[i+1])
+    std::vector<uint32_t> items;
+};
+
+inline int ObstacleGrid::cellCoord(float v, int axis) const
+{
+    int c = static_cast<int>(std::floor((v - origin[axis]) * invCellSize));
+    return std::min(std::max(c, 0), dims[axis] - 1);
+}
+
+template<typename Visitor>
+bool ObstacleGrid::visit(const glm::vec3& center, float radius, Visitor visitor) const
+{
+    if(items.empty()) return false;
+
+    // 查询范围完全在网格之外时直接返回，否则夹到网格范围内
+    for(int axis = 0; axis < 3; ++axis) {
+        float gridMax = origin[axis] + dims[axis] * cellSize;
+        if(center[axis] + radius < origin[axis] || center[axis] - radius > gridMax) return false;
+    }
+
+    int minX = cellCoord(center.x - radius, 0), maxX = cellCoord(center.x + radius, 0);
+    int minY = cellCoord(center.y - radius, 1), maxY = cellCoord(center.y + radius, 1);
+    int minZ = cellCoord(center.z - radius, 2), maxZ = cellCoord(center.z + radius, 2);
+
+    for(int z = minZ; z <= maxZ; ++z) {
+        for(int y = minY; y <= maxY; ++y) {
+            for(int x = minX; x <= maxX; ++x) {
+                size_t cell = cellIndex(x, y, z);
+                for(uint32_t i = cellStart[cell]; i < cellStart[cell + 1]; ++i) {
+                    if(visitor(items[i])) return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+#endif // OBSTACLEGRID_H
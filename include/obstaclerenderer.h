@@ -0,0 +1,33 @@
+#ifndef OBSTACLERENDERER_H
+#define OBSTACLERENDERER_H
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <QString>
+#include "obstacle.h"
+#include "memorystats.h"
+
+// 障碍物的绘制，尖刺球使用OBJ模型，立方体直接绘制
+class ObstacleRenderer {
+public:
+    // 加载尖刺球模型，失败时只能绘制立方体
+    static bool loadSphereModel();
+    // 从指定文件加载并替换已加载的模型
+    static bool loadSphereModel(const QString& filePath);
+    static bool isModelLoaded() { return modelLoaded; }
+    static void reportMemory(MemoryReport& report);  // 所有 GameWidget 共用的模型数据
+
+    static void draw(const Obstacle& obstacle);
+
+private:
+    static void drawCube(float size);
+    static void drawSpikySphere(float size);
+    
+    // OBJ模型数据
+    static std::vector<glm::vec3> sphereVertices;
+    static std::vector<glm::vec3> sphereNormals;
+    static std::vector<std::vector<int>> sphereFaces;
+    static bool modelLoaded;
+};
+
+#endif // OBSTACLERENDERER_H
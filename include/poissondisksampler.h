@@ -0,0 +1,123 @@
+#ifndef POISSONDISKSAMPLER_H
+#define POISSONDISKSAMPLER_H
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+#include "rng.h"
+#include "memorystats.h"
+
+// 增量式泊松圆盘采样（Bridson），用于在长方体区域内放置两两间距不小于 minDistance 的点
+// 背景网格单元边长约为 minDistance/√3，距离检查只访问邻近单元，与已有点数无关
+// 候选点先在整个区域内均匀抽取，保持稀疏时的均匀分布；连续失败后改为在活动点周围的
+// [r, 2r] 球壳内抽取，稠密时也能快速找到空隙。活动点连续失败 ANNULUS_ATTEMPTS 次后退役，
+// 移除点时重新激活附近的点。失败计数跨调用保留，总尝试次数均摊到每次激活不超过 ANNULUS_ATTEMPTS
+class PoissonDiskSampler {
+public:
+    PoissonDiskSampler();
+
+    // 设置采样区域与最小间距并清空所有点
+    void reset(const glm::vec3& min, const glm::vec3& max, float minDistance);
+    void clear();
+
+    // 点按加入顺序存放，移除时末尾的点移到空出的下标，调用方可以用同样的交换弹出维护平行数组
+    bool insert(const glm::vec3& point);   // 间距满足时加入末尾并激活
+    void remove(const glm::vec3& point);   // 移除位于该位置的点
+    void removeAt(size_t index);
+    bool isFarEnough(const glm::vec3& point) const;
+
+    // 最多尝试 maxAttempts 个候选点，accept(const glm::vec3&) 做额外的合法性检查（如障碍物）
+    // 成功时加入该点并写入 out；活动点全部退役后提前返回 false
+    template<typename Accept>
+    bool sample(Rng& rng, int maxAttempts, Accept accept, glm::vec3& out);
+
+    // 遍历与以center为球心、radius为半径的球的包围盒重叠的单元中的点
+    // visitor(size_t index, const glm::vec3& position)
+    template<typename Visitor>
+    void visit(const glm::vec3& center, float radius, Visitor visitor) const;
+
+    size_t size() const { return samples.size(); }
+    const glm::vec3& position(size_t index) const { return samples[index].position; }
+    size_t activeCount() const { return active.size(); }
+    MemoryUsage memoryUsage() const;
+
+    static constexpr int UNIFORM_ATTEMPTS = 8;    // 每次采样先尝试的均匀候选点数
+    static constexpr int ANNULUS_ATTEMPTS = 30;   // 活动点退役前允许的失败次数（Bridson 的 k）
+    static constexpr size_t MAX_CELLS = size_t(1) << 22;
+
+private:
+    struct Sample {
+        glm::vec3 position;
+        int32_t next;          // 同一单元内的下一个点，-1 表示没有
+        int32_t activeSlot;    // 在 active 中的下标，-1 表示未激活
+    };
+
+    struct ActivePoint {
+        uint32_t sample;
+        int failures;
+    };
+
+    // 生成第 attempt 个候选点，activeSlot 为所用活动点的下标，均匀候选时为 -1
+    glm::vec3 candidate(Rng& rng, int attempt, int& activeSlot);
+    void reject(int activeSlot);
+    bool contains(const glm::vec3& point) const;
+    int cellCoord(float v, int axis) const;
+    size_t cellOf(const glm::vec3& point) const;
+    int findSample(const glm::vec3& point) const;
+    void unlink(int index);
+    void link(int index);
+    void activate(int index);
+    void deactivate(int index);
+
+    glm::vec3 boundsMin;
+    glm::vec3 boundsMax;
+    float minDistance;
+    float cellSize;
+    float invCellSize;
+    int dims[3];
+    int searchRadius;                  // 距离检查需要访问的邻近单元层数
+    std::vector<int32_t> cellHead;     // 每个单元第一个点的下标，-1 表示空
+    std::vector<Sample> samples;
+    std::vector<ActivePoint> active;
+};
+
+template<typename Accept>
+bool PoissonDiskSampler::sample(Rng& rng, int maxAttempts, Accept accept, glm::vec3& out)
+{
+    for(int attempt = 0; attempt < maxAttempts; ++attempt) {
+        int activeSlot = -1;
+        glm::vec3 point = candidate(rng, attempt, activeSlot);
+        if(contains(point) && isFarEnough(point) && accept(point)) {
+            insert(point);
+            out = point;
+            return true;
+        }
+        reject(activeSlot);
+        // 没有活动点时区域已经填满，继续均匀抽取几乎不可能成功
+        if(attempt + 1 >= UNIFORM_ATTEMPTS && active.empty()) break;
+    }
+    return false;
+}
+
+template<typename Visitor>
+void PoissonDiskSampler::visit(const glm::vec3& center, float radius, Visitor visitor) const
+{
+    if(samples.empty()) return;
+
+    int minX = cellCoord(center.x - radius, 0), maxX = cellCoord(center.x + radius, 0);
+    int minY = cellCoord(center.y - radius, 1), maxY = cellCoord(center.y + radius, 1);
+    int minZ = cellCoord(center.z - radius, 2), maxZ = cellCoord(center.z + radius, 2);
+
+    for(int z = minZ; z <= maxZ; ++z) {
+        for(int y = minY; y <= maxY; ++y) {
+            for(int x = minX; x <= maxX; ++x) {
+                size_t cell = (static_cast<size_t>(z) * dims[1] + y) * dims[0] + x;
+                for(int i = cellHead[cell]; i >= 0; i = samples[i].next) {
+                    visitor(static_cast<size_t>(i), samples[i].position);
+                }
+            }
+        }
+    }
+}
+
+#endif // POISSONDISKSAMPLER_H
@@ -0,0 +1,55 @@
+#ifndef RENDERBENCHMARK_H
+#define RENDERBENCHMARK_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+class GameWidget;
+
+// 离屏渲染基准测试：在 QOffscreenSurface + FBO 上驱动 GameWidget 渲染固定帧数，
+// 摄像机沿脚本路径依次经过水面上方环绕、水下穿行和俯视三段，结束后打印统计
+// 不需要显示器，可在 Mesa llvmpipe 下运行（QT_QPA_PLATFORM=offscreen）
+class RenderBenchmark {
+public:
+    struct Options {
+        int frames = 600;
+        int width = 1280;
+        int height = 720;
+    };
+
+    explicit RenderBenchmark(const Options& options);
+
+    // 返回进程退出码，需在 QApplication 创建之后调用
+    int run();
+
+private:
+    enum Segment {
+        ABOVE_WATER = 0,
+        UNDERWATER,
+        TOP_DOWN,
+        SEGMENT_COUNT
+    };
+
+    struct FrameSample {
+        Segment segment;
+        float frameTime;        // 毫秒，paintGL 加 glFinish
+        uint64_t drawCalls;
+        uint64_t vertices;      // 不支持管线统计查询时为0
+    };
+
+    static const char* segmentName(Segment segment);
+    Segment segmentOf(int frame) const;
+    void setupCamera(GameWidget& widget, int frame) const;
+    void printReport() const;
+    static void printPercentiles(const char* label, std::vector<float> times);
+
+    static constexpr uint64_t BENCHMARK_SEED = 1;
+    static constexpr float FRAME_DELTA = 1.0f / 60.0f;   // 水面和粒子动画的固定步长
+
+    Options options;
+    bool vertexQueries;
+    std::vector<FrameSample> samples;
+};
+
+#endif // RENDERBENCHMARK_H
@@ -0,0 +1,15 @@
+#ifndef RENDERSTATS_H
+#define RENDERSTATS_H
+
+#include <cstdint>
+
+// 绘制调用计数，每个 glDraw* 或 glBegin/glEnd 计一次
+// 只在渲染线程中累加，由渲染基准测试逐帧读取并清零
+namespace RenderStats {
+    inline uint64_t drawCalls = 0;
+
+    inline void countDraw() { ++drawCalls; }
+    inline void reset() { drawCalls = 0; }
+}
+
+#endif // RENDERSTATS_H
@@ -0,0 +1,111 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+
+// 各子系统独立的随机数流，互不共享状态，可以分别播种和并行使用
+enum class RngStream : uint64_t {
+    WORLD = 1,              // 食物与障碍物，决定游戏结果
+    WATER_PARTICLES,        // 蛇头附近的水粒子
+    UNDERWATER_PARTICLES,   // 水下漂浮粒子
+    BUBBLES,
+    CAUSTICS,               // 焦散纹理生成
+    FOOD_SPAWN              // 后台预生成的食物候选位置，决定游戏结果
+};
+
+// PCG32（XSH-RR 变体）：64位状态，32位输出
+// 同一种子下不同的流号对应不同的增量，产生互不相关的序列
+// 结果只由种子和流号决定，不依赖标准库的实现
+class Rng {
+public:
+    Rng() { seed(0, 0); }
+    Rng(uint64_t seedValue, RngStream stream) { seed(seedValue, static_cast<uint64_t>(stream)); }
+
+    void seed(uint64_t seedValue, uint64_t stream)
+    {
+        // 先用 splitmix64 打散，相近的种子也能得到差异很大的初始状态
+        uint64_t mixed = seedValue + stream * 0x9e3779b97f4a7c15ull;
+        increment = (splitmix64(mixed) << 1) | 1u;
+        state = 0;
+        nextU32();
+        state += splitmix64(mixed);
+        nextU32();
+    }
+
+    uint32_t nextU32()
+    {
+        uint64_t old = state;
+        state = old * 6364136223846793005ull + increment;
+        uint32_t xorshifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+        uint32_t rot = static_cast<uint32_t>(old >> 59);
+        return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+    }
+
+    // [0, 1)，取高24位以保证结果可以精确表示
+    float nextFloat() { return static_cast<float>(nextU32() >> 8) * (1.0f / 16777216.0f); }
+    float uniform(float min, float max) { return min + (max - min) * nextFloat(); }
+    float signedUnit() { return nextFloat() * 2.0f - 1.0f; }   // [-1, 1)
+
+    // [0, bound)，无偏
+    uint32_t below(uint32_t bound)
+    {
+        uint64_t product = static_cast<uint64_t>(nextU32()) * bound;
+        uint32_t low = static_cast<uint32_t>(product);
+        if(low < bound) {
+            uint32_t threshold = (0u - bound) % bound;
+            while(low < threshold) {
+                product = static_cast<uint64_t>(nextU32()) * bound;
+                low = static_cast<uint32_t>(product);
+            }
+        }
+        return static_cast<uint32_t>(product >> 32);
+    }
+
+    // 批量生成 [min, max) 内的浮点数，热循环中先整体填充再使用，避免逐个调用
+    void fillUniform(float* out, size_t count, float min, float max)
+    {
+        const float scale = (max - min) * (1.0f / 16777216.0f);
+        uint64_t s = state;
+        for(size_t i = 0; i < count; ++i) {
+            uint64_t old = s;
+            s = old * 6364136223846793005ull + increment;
+            uint32_t xorshifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+            uint32_t rot = static_cast<uint32_t>(old >> 59);
+            uint32_t bits = (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+            out[i] = min + static_cast<float>(bits >> 8) * scale;
+        }
+        state = s;
+    }
+
+    // 每个分量均在 [min, max) 内的向量
+    void fillUniform(glm::vec3* out, size_t count, float min, float max)
+    {
+        static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "glm::vec3 must be tightly packed");
+        if(count == 0) return;
+        fillUniform(&out[0].x, count * 3, min, max);
+    }
+
+    // 由当前状态派生出一个新的流，用于把一个子系统的工作拆给多个线程
+    Rng split(uint64_t stream) const
+    {
+        Rng child;
+        child.seed(state ^ increment, stream);
+        return child;
+    }
+
+private:
+    static uint64_t splitmix64(uint64_t& x)
+    {
+        uint64_t z = (x += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    uint64_t state;
+    uint64_t increment;   // 必须为奇数
+};
+
+#endif // RNG_H
@@ -0,0 +1,78 @@
+#ifndef SEGMENTHASH_H
+#define SEGMENTHASH_H
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cmath>
+#include "memorystats.h"
+
+// 蛇身段的均匀空间哈希，单元边长等于段尺寸
+// 蛇头进入、蛇尾离开时增量更新，查询只访问与查询球相交的单元
+class SegmentHash {
+public:
+    struct Entry {
+        glm::vec3 position;
+        uint64_t sequence;  // 段序号，见 SnakeBody::headSequence()
+    };
+
+    explicit SegmentHash(float cellSize);
+
+    void clear();
+    void insert(uint64_t sequence, const glm::vec3& position);
+    void remove(uint64_t sequence, const glm::vec3& position);
+    size_t cellCount() const { return cells.size(); }
+    MemoryUsage memoryUsage() const;
+
+    // 遍历与以center为球心、radius为半径的球可能相交的所有段
+    // visitor(const Entry&) 返回true时提前结束，函数也返回true
+    template<typename Visitor>
+    bool visit(const glm::vec3& center, float radius, Visitor visitor) const;
+
+private:
+    typedef std::vector<Entry> Cell;
+
+    int cellCoord(float v) const { return static_cast<int>(std::floor(v * invCellSize)); }
+    static uint64_t makeKey(int x, int y, int z);
+    uint64_t keyOf(const glm::vec3& p) const { return makeKey(cellCoord(p.x), cellCoord(p.y), cellCoord(p.z)); }
+
+    float cellSize;
+    float invCellSize;
+    std::unordered_map<uint64_t, Cell> cells;
+};
+
+inline uint64_t SegmentHash::makeKey(int x, int y, int z)
+{
+    // 每个坐标取低21位，足以覆盖水族箱范围
+    const uint64_t MASK = (1u << 21) - 1;
+    return ((static_cast<uint64_t>(x) & MASK) << 42) |
+           ((static_cast<uint64_t>(y) & MASK) << 21) |
+           (static_cast<uint64_t>(z) & MASK);
+}
+
+template<typename Visitor>
+bool SegmentHash::visit(const glm::vec3& center, float radius, Visitor visitor) const
+{
+    if(cells.empty()) return false;
+
+    int minX = cellCoord(center.x - radius), maxX = cellCoord(center.x + radius);
+    int minY = cellCoord(center.y - radius), maxY = cellCoord(center.y + radius);
+    int minZ = cellCoord(center.z - radius), maxZ = cellCoord(center.z + radius);
+
+    for(int x = minX; x <= maxX; ++x) {
+        for(int y = minY; y <= maxY; ++y) {
+            for(int z = minZ; z <= maxZ; ++z) {
+                auto it = cells.find(makeKey(x, y, z));
+                if(it == cells.end()) continue;
+
+                for(const Entry& entry : it->second) {
+                    if(visitor(entry)) return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+#endif // SEGMENTHASH_H
@@ -0,0 +1,36 @@
+#ifndef SIMULATIONCONFIG_H
+#define SIMULATIONCONFIG_H
+
+#include <string>
+#include <vector>
+#include "gameworld.h"
+#include "snakecore.h"
+#include "inputlog.h"
+
+// 启动时可覆盖的规模参数，用于压力测试各子系统的扩展性
+// 来源按顺序叠加：预设、配置文件、单项命令行选项
+// 配置文件每行一个 key=value，# 开头为注释，键名与 keys() 相同，另可用 preset=<名称>
+// 水族箱大小、食物、障碍物和蛇长会改变模拟结果，录制时写入日志头部，回放时改用日志中的值
+struct SimulationConfig {
+    float aquariumSize = GameWorld::DEFAULT_AQUARIUM_SIZE;
+    int obstacleCount = GameWorld::MAX_OBSTACLES;
+    int foodCount = GameWorld::MIN_FOOD_COUNT;
+    int waterParticleCount = 1000;                  // 与 Water::MAX_WATER_PARTICLES 一致
+    int snakeLength = SnakeCore::INITIAL_LENGTH;    // 以 SnakeCore::getLength 计
+
+    // 未知的名称、键或无法解析的值返回 false，并在 error 中说明原因
+    bool applyPreset(const std::string& name, std::string& error);
+    bool set(const std::string& key, const std::string& value, std::string& error);
+    bool loadFile(const std::string& path, std::string& error);
+
+    std::string summary() const;
+
+    // 影响模拟结果的部分，水体粒子数只影响渲染，不包含在内
+    SimulationScale scale() const;
+    void applyScale(const SimulationScale& scale);
+
+    static const std::vector<std::string>& presetNames();
+    static const std::vector<std::string>& keys();
+};
+
+#endif // SIMULATIONCONFIG_H
@@ -11,50 +11,54 @@
 #include <glm/gtx/rotate_vector.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <QOpenGLFunctions>
+#include "snakecore.h"
+#include "frustumculler.h"
 
-class Snake : protected QOpenGLFunctions {
+class QOpenGLContext;
+
+// 蛇的渲染：在 SnakeCore 的逻辑状态之上负责实例化球体、管状网格和背鳍的绘制
+class Snake : public SnakeCore, protected QOpenGLFunctions {
 public:
-    Snake(float startX = 0.0f, float startY = 0.0f, float startZ = 0.0f);
+    Snake(float startX = 0.0f, float startY = 0.0f, float startZ = 0.0f, int initialLength = INITIAL_LENGTH);
+    ~Snake();
     void initializeGL();
-    void move();
-    void grow();
-    void setDirection(const glm::vec3& newDir);
-    bool checkCollision(const glm::vec3& point) const;
     void draw();
     void drawSphere(float radius, int sectors, int stacks);
-    glm::vec3 getHeadPosition() const { return body.front(); }
-    const std::vector<glm::vec3>& getBody() const { return body; }
-    glm::vec3 getDirection() const { return direction; }
-    bool checkSelfCollision() const;
-    float getMovementSpeed() const { return moveSpeed; }
-    static constexpr float GROWTH_FACTOR = 3;
-    float getSegmentSize() const { return DEFAULT_SEGMENT_SIZE; }
-    glm::vec3 getUpDirection() const { return upDirection; }
-    glm::vec3 getRightDirection() const { return glm::normalize(glm::cross(direction, upDirection)); }
-    void rotateAroundAxis(const glm::vec3& axis, float angle);
     void setProjectionMatrix(const glm::mat4& proj) { projectionMatrix = proj; }
     void setViewMatrix(const glm::mat4& view) { viewMatrix = view; }
 
+    // 渲染插值：每个逻辑帧开始前保存状态，绘制时在上一帧与当前帧之间按alpha插值
+    void storePreviousState();
+    void setRenderAlpha(float alpha) { renderAlpha = alpha; }
+    void setTubeRendering(bool enabled) { tubeRendering = enabled; }
+    bool isTubeRendering() const { return tubeRendering; }
+    void reportMemory(MemoryReport& report) const override;
+
 private:
-    void drawDorsalFin(const glm::vec3& pos, const glm::vec3& dir, const glm::vec3& up, float size);
+    void appendDorsalFin(const glm::vec3& pos, const glm::vec3& dir, const glm::vec3& up, float size);
+    void drawFins();
     void setGradientColor(float t) const;
     bool isSegmentInFrustum(const glm::vec3& position, float radius) const;
+    void cullSegments();
     void extractFrustumPlanes();
     
-    std::vector<glm::vec3> body;
-    glm::vec3 direction;
-    glm::vec3 targetDirection;
-    float segmentSize;
-    float moveSpeed;
-    static constexpr float DEFAULT_SEGMENT_SIZE = 50.0f;
-    static constexpr float DEFAULT_MOVE_SPEED = 10.0f;
-    static constexpr float TURN_SPEED = 0.2f;
-    static constexpr float MIN_DIRECTION_CHANGE = 0.05f;
-    static constexpr float MAX_TURN_ANGLE = 90.0f;
-    glm::vec3 upDirection;
+    glm::vec3 previousHead;   // 上一逻辑帧的蛇头和蛇尾，用于渲染插值
+    glm::vec3 previousTail;
+    float renderAlpha;
+    
+    glm::vec3 renderPosition(size_t index) const;
     
     static constexpr float FIN_HEIGHT_RATIO = 0.6f;
     static constexpr float FIN_LENGTH_RATIO = 0.8f;
+
+    // 每帧所有背鳍的顶点，合并为一次 glDrawArrays
+    struct FinVertex {
+        glm::vec3 position;
+        glm::vec3 normal;
+        glm::vec3 color;
+    };
+    std::vector<FinVertex> finVertices;
+    GLuint finVBO;
     
     static constexpr float GRADIENT_TOP_R = 0.2f;
     static constexpr float GRADIENT_TOP_G = 0.8f;
@@ -62,13 +66,62 @@ private:
     static constexpr float GRADIENT_BOTTOM_R = 0.1f;
     static constexpr float GRADIENT_BOTTOM_G = 0.5f;
     static constexpr float GRADIENT_BOTTOM_B = 0.1f;
-    
-    void updateDirections();
+
+    // 实例化渲染：静态单位球网格 + 每段一个实例（位置、半径、渐变参数）
+    struct SegmentInstance {
+        glm::vec3 position;
+        float radius;
+        float gradient;
+    };
+    void initInstancedRendering();
+    void releaseInstancedRendering();
+    void drawSegmentsInstanced();
+    GLuint buildProgram(const char* vertexSource, const char* fragmentSource, const char* name);
+    void setShadingUniforms(GLuint program);
+
+    static const char* segmentVertexShader;
+    static const char* segmentFragmentShader;
+    static const char* tubeVertexShader;
+
+    bool instancingInitialized;
+    QOpenGLContext* glContext;        // 创建GL资源时的上下文
+    GLuint segmentProgram;            // 为0时回退到立即模式
+    GLuint instanceVBO;
+    std::vector<SegmentInstance> instanceData;
+    static constexpr int INSTANCED_SPHERE_SECTORS = 20;
+    static constexpr int INSTANCED_SPHERE_STACKS = 20;
+
+    // 管状渲染：路径点和平行移动标架按段序号取模存放在纹理缓冲区中，
+    // 中间的采样点位置固定，其标架只在压入新点后计算并局部上传一次，
+    // 每帧只重算插值的蛇头、蛇尾和紧邻蛇头的环。
+    // 顶点着色器根据 gl_VertexID 沿路径扫掠圆形截面，一次绘制完成整条蛇身
+    void buildTubeFrames();
+    void drawTube();
+    glm::vec3 tubeTangent(size_t index, const glm::vec3& fallback) const;
+    void writeTubeRing(uint64_t sequence, size_t index, const glm::vec3& tangent, const glm::vec3& normal);
+    void startTubeRing(uint64_t sequence, size_t index);
+    void transportTubeRing(uint64_t fromSequence, uint64_t sequence, size_t index);
+    void uploadTubeRings(uint64_t firstSequence, uint64_t lastSequence);
+
+    bool tubeRendering;
+    GLuint tubeProgram;               // 为0时管状模式回退到球体
+    GLuint tubeBuffer;
+    GLuint tubeTexture;
+    std::vector<glm::vec4> tubeData;  // 每个环3个texel：中心、法线、副法线，序号s位于 (s & tubeMask) * 3
+    size_t tubeMask;                  // 环的容量减一，容量为2的幂
+    bool tubeCacheValid;
+    uint64_t tubeCachedThrough;       // 已计算并上传的最新固定环的序号
+    std::vector<GLint> tubeFirsts;
+    std::vector<GLsizei> tubeCounts;
+    static constexpr int TUBE_SIDES = 16;
+    static constexpr int TUBE_TEXELS_PER_RING = 3;
 
     glm::mat4 projectionMatrix;
     glm::mat4 viewMatrix;
     glm::vec4 frustumPlanes[6];
     bool frustumPlanesUpdated;
+    FrustumCuller frustumCuller;
+    std::vector<uint32_t> visibleSegments;  // 本帧可见段的逻辑下标，从头到尾有序
 };
 
 #endif // SNAKE_H
\ No newline at end of file
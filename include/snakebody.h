@@ -0,0 +1,94 @@
+#ifndef SNAKEBODY_H
+#define SNAKEBODY_H
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include "memorystats.h"
+
+// 蛇身的环形缓冲区存储
+// 逻辑下标0为蛇头，size()-1为蛇尾；两端的插入与删除均为O(1)
+class SnakeBody {
+public:
+    // 一段连续内存，遍历时无需拷贝
+    struct Span {
+        const glm::vec3* data;
+        size_t size;
+    };
+
+    // 坐标分量分开存放的连续内存，供SIMD批处理使用
+    struct SoaSpan {
+        const float* x;
+        const float* y;
+        const float* z;
+        size_t size;
+    };
+
+    class const_iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef glm::vec3 value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const glm::vec3* pointer;
+        typedef const glm::vec3& reference;
+
+        const_iterator(const SnakeBody* body, size_t index) : body(body), index(index) {}
+        reference operator*() const { return (*body)[index]; }
+        pointer operator->() const { return &(*body)[index]; }
+        const_iterator& operator++() { ++index; return *this; }
+        const_iterator operator++(int) { const_iterator tmp(*this); ++index; return tmp; }
+        bool operator==(const const_iterator& other) const { return index == other.index; }
+        bool operator!=(const const_iterator& other) const { return index != other.index; }
+
+    private:
+        const SnakeBody* body;
+        size_t index;
+    };
+
+    SnakeBody();
+
+    void clear();
+    void pushBack(const glm::vec3& pos);       // 在尾部追加一段
+    void pushFront(const glm::vec3& pos);      // 在头部插入一段，成为新蛇头
+    void popFront();                           // 移除蛇头
+    void popBack();                            // 移除蛇尾
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    size_t capacity() const { return storage.size(); }
+    MemoryUsage memoryUsage() const;  // 包含 SoA 镜像
+
+    const glm::vec3& operator[](size_t i) const { return storage[(head + i) & mask]; }
+    const glm::vec3& front() const { return storage[head]; }
+    const glm::vec3& back() const { return (*this)[count - 1]; }
+
+    // 每段拥有序号：逻辑下标i的序号为 headSequence() - i
+    // 头部插入序号加一、移除序号减一，因此序号在段的生命周期内保持不变
+    uint64_t headSequence() const { return headSeq; }
+    uint64_t tailSequence() const { return headSeq - (count - 1); }
+    size_t indexOfSequence(uint64_t seq) const { return static_cast<size_t>(headSeq - seq); }
+
+    // 按从头到尾的顺序返回至多两段连续内存，返回段数
+    size_t spans(Span out[2]) const;
+    size_t soaSpans(SoaSpan out[2]) const;
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, count); }
+
+private:
+    void reserveFor(size_t required);
+    void store(size_t slot, const glm::vec3& pos);
+
+    std::vector<glm::vec3> storage;  // 容量始终为2的幂
+    std::vector<float> xs;           // storage 的SoA镜像，与其下标一一对应
+    std::vector<float> ys;
+    std::vector<float> zs;
+    size_t head;                     // 蛇头在storage中的位置
+    size_t count;                    // 当前段数
+    size_t mask;                     // storage.size() - 1
+    uint64_t headSeq;                // 蛇头的序号
+};
+
+#endif // SNAKEBODY_H
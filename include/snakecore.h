@@ -0,0 +1,74 @@
+#ifndef SNAKECORE_H
+#define SNAKECORE_H
+
+#define GLM_ENABLE_EXPERIMENTAL
+
+#include <glm/glm.hpp>
+#include <glm/gtx/rotate_vector.hpp>
+#include <cstdint>
+#include "snakebody.h"
+#include "segmenthash.h"
+#include "chunkbounds.h"
+#include "memorystats.h"
+
+// 蛇的移动、增长与碰撞逻辑，不依赖Qt和OpenGL
+// 渲染由派生类 Snake 完成
+class SnakeCore {
+public:
+    // 初始蛇身沿 -X 方向伸直排列，initialLength 以 getLength 计
+    SnakeCore(float startX = 0.0f, float startY = 0.0f, float startZ = 0.0f, int initialLength = INITIAL_LENGTH);
+    virtual ~SnakeCore() = default;
+
+    void move();
+    void grow();
+    void setDirection(const glm::vec3& newDir);
+    void rotateAroundAxis(const glm::vec3& axis, float angle);
+    bool checkCollision(const glm::vec3& point) const;
+    bool checkSelfCollision() const;
+
+    glm::vec3 getHeadPosition() const { return body.front(); }
+    const SnakeBody& getBody() const { return body; }
+    const ChunkBounds& getChunkBounds() const { return chunkBounds; }
+    virtual void reportMemory(MemoryReport& report) const;  // snake.* 各项，派生类追加渲染数据
+    int getLength() const;
+    glm::vec3 getDirection() const { return direction; }
+    glm::vec3 getUpDirection() const { return upDirection; }
+    glm::vec3 getRightDirection() const { return glm::normalize(glm::cross(direction, upDirection)); }
+    float getMovementSpeed() const { return moveSpeed; }
+    float getSegmentSize() const { return DEFAULT_SEGMENT_SIZE; }
+    static constexpr float GROWTH_FACTOR = 3;
+    static constexpr int INITIAL_LENGTH = 3;
+
+protected:
+    // 蛇身按弧长参数化：body[0]为蛇头，body[size()-1]为插值得到的蛇尾，
+    // 中间为蛇头轨迹上弧长恰为 segmentSize 整数倍的固定采样点
+    // 采样点一经生成位置不变，因此存储与哈希更新都是增量的
+    SnakeBody body;
+    SegmentHash segmentHash;  // 蛇身段的空间哈希，用于碰撞宽相
+    ChunkBounds chunkBounds;  // 每32段一组的包围盒，用于视锥体剔除
+    double odometer;          // 蛇头累计行进的弧长
+    float length;             // 蛇身弧长
+    float pendingGrowth;      // 尚未体现到蛇身上的增长量，蛇尾停留等待
+    uint64_t nextSampleIndex;    // 下一个待生成的采样点编号k，弧长为 k * segmentSize
+    uint64_t oldestSampleIndex;  // body中最靠近蛇尾的采样点编号
+    glm::vec3 tailAnchor;     // 最近被蛇尾越过的采样点，用于插值蛇尾
+    double tailAnchorOdometer;
+
+    double arcPosition(size_t index) const;
+    void indexSegment(uint64_t sequence, const glm::vec3& position);
+    void unindexSegment(uint64_t sequence, const glm::vec3& position);
+    void updateDirections();
+
+    glm::vec3 direction;
+    glm::vec3 targetDirection;
+    glm::vec3 upDirection;
+    float segmentSize;
+    float moveSpeed;
+    static constexpr float DEFAULT_SEGMENT_SIZE = 50.0f;
+    static constexpr float DEFAULT_MOVE_SPEED = 10.0f;
+    static constexpr float TURN_SPEED = 0.2f;
+    static constexpr float MIN_DIRECTION_CHANGE = 0.05f;
+    static constexpr float MAX_TURN_ANGLE = 90.0f;
+};
+
+#endif // SNAKECORE_H
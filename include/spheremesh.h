@@ -0,0 +1,104 @@
+#ifndef SPHEREMESH_H
+#define SPHEREMESH_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <map>
+#include <memory>
+#include <utility>
+#include "memorystats.h"
+
+class QOpenGLContextGroup;
+
+// 编译期三角函数表，用于生成球体网格
+namespace SphereTrig {
+    constexpr double PI = 3.14159265358979323846;
+
+    // 泰勒级数计算正弦，输入范围 [0, 2π]
+    constexpr double sine(double x)
+    {
+        if(x > PI) x -= 2.0 * PI;
+        double term = x;
+        double sum = x;
+        for(int n = 1; n < 16; ++n) {
+            term *= -x * x / ((2.0 * n) * (2.0 * n + 1.0));
+            sum += term;
+        }
+        return sum;
+    }
+
+    constexpr double cosine(double x)
+    {
+        double shifted = x + PI * 0.5;
+        return sine(shifted > 2.0 * PI ? shifted - 2.0 * PI : shifted);
+    }
+
+    // phi ∈ [0, π] 按 Stacks 等分，theta ∈ [0, 2π] 按 Sectors 等分
+    template<int Sectors, int Stacks>
+    struct Table {
+        float sinPhi[Stacks + 1];
+        float cosPhi[Stacks + 1];
+        float sinTheta[Sectors + 1];
+        float cosTheta[Sectors + 1];
+
+        constexpr Table() : sinPhi(), cosPhi(), sinTheta(), cosTheta()
+        {
+            for(int i = 0; i <= Stacks; ++i) {
+                double phi = PI * i / Stacks;
+                sinPhi[i] = static_cast<float>(sine(phi));
+                cosPhi[i] = static_cast<float>(cosine(phi));
+            }
+            for(int j = 0; j <= Sectors; ++j) {
+                double theta = 2.0 * PI * j / Sectors;
+                sinTheta[j] = static_cast<float>(sine(theta));
+                cosTheta[j] = static_cast<float>(cosine(theta));
+            }
+        }
+    };
+}
+
+// 带索引的单位球网格（顶点即法线），按 (sectors, stacks) 全局缓存
+// 几何数据只生成一次，每个GL上下文组首次使用时上传到VBO/IBO
+class SphereMesh {
+public:
+    static const SphereMesh& get(int sectors, int stacks);
+
+    int getSectors() const { return sectors; }
+    int getStacks() const { return stacks; }
+    const std::vector<glm::vec3>& getVertices() const { return vertices; }
+    const std::vector<GLuint>& getIndices() const { return indices; }
+    GLsizei getIndexCount() const { return static_cast<GLsizei>(indices.size()); }
+
+    // 绑定当前上下文组中的VBO和IBO，没有可用上下文时返回false
+    bool bindBuffers() const;
+
+    // 使用固定管线以给定半径绘制（调用前设置好模型视图矩阵和颜色）
+    void draw(float radius) const;
+
+    // 所有缓存网格的几何数据，以及每个上下文组中的缓冲区
+    static void reportMemory(MemoryReport& report);
+
+    SphereMesh(int sectors, int stacks);
+
+private:
+    template<int Sectors, int Stacks>
+    void buildFromTable();
+    void buildRuntime();
+    void buildIndices();
+
+    struct GpuBuffers {
+        GLuint vbo;
+        GLuint ibo;
+    };
+
+    int sectors;
+    int stacks;
+    std::vector<glm::vec3> vertices;
+    std::vector<GLuint> indices;
+    mutable std::map<QOpenGLContextGroup*, GpuBuffers> gpuBuffers;
+
+    static std::map<std::pair<int, int>, std::unique_ptr<SphereMesh>> cache;
+};
+
+#endif // SPHEREMESH_H
@@ -0,0 +1,88 @@
+#ifndef TRACERECORDER_H
+#define TRACERECORDER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "memorystats.h"
+
+// 时间线追踪：记录各阶段的起止时间，按需导出最近若干秒为 Chrome/Perfetto 的 trace-event JSON
+// 事件写入固定容量的无锁环形缓冲区，写满后覆盖最旧的事件，任意线程都可以记录
+// 分类与名称只保存指针，必须是字符串字面量等静态存储的字符串
+class TraceRecorder {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = size_t(1) << 17;   // 约 60 FPS 下一分钟的事件
+
+    explicit TraceRecorder(size_t capacity = DEFAULT_CAPACITY);   // 容量向上取整为2的幂
+    static TraceRecorder& instance();
+
+    void setEnabled(bool enable) { enabled.store(enable, std::memory_order_relaxed); }
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    static uint64_t now();   // steady_clock 纳秒
+    void record(const char* category, const char* name, uint64_t start, uint64_t end);
+
+    // 为当前线程命名，导出时作为时间线上的线程标签；已有同名线程时沿用它的编号
+    void setThreadName(const std::string& name);
+
+    // 只导出在最近 lastSeconds 秒内结束的事件
+    std::string toJson(double lastSeconds) const;
+    bool writeJson(const std::string& path, double lastSeconds) const;
+
+    MemoryUsage memoryUsage() const;
+
+private:
+    // 顺序锁：sequence 为 0 表示正在写入，为 index + 1 表示第 index 个事件已写完
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<const char*> category{nullptr};
+        std::atomic<const char*> name{nullptr};
+        std::atomic<uint64_t> start{0};
+        std::atomic<uint64_t> end{0};
+        std::atomic<uint32_t> thread{0};
+    };
+
+    static uint32_t currentThreadId();
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask;
+    std::atomic<uint64_t> head;
+    std::atomic<bool> enabled;
+
+    mutable std::mutex threadNamesMutex;
+    std::vector<std::pair<uint32_t, std::string>> threadNames;
+};
+
+// 作用域事件，析构时写入一条完整事件（起点加时长）
+class TraceScope {
+public:
+    TraceScope(const char* category, const char* name)
+        : category(category)
+        , name(name)
+        , start(TraceRecorder::instance().isEnabled() ? TraceRecorder::now() : 0)
+    {
+    }
+    ~TraceScope()
+    {
+        if(start) TraceRecorder::instance().record(category, name, start, TraceRecorder::now());
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* category;
+    const char* name;
+    uint64_t start;
+};
+
+#define AQ_TRACE_CONCAT_INNER(a, b) a##b
+#define AQ_TRACE_CONCAT(a, b) AQ_TRACE_CONCAT_INNER(a, b)
+#define AQ_TRACE_SCOPE(category, name) TraceScope AQ_TRACE_CONCAT(aqTraceScope, __LINE__)(category, name)
+
+#endif // TRACERECORDER_H
@@ -22,6 +22,21 @@ public:
     explicit GameHUD(QWidget *parent = nullptr);
     void updateLength(int length);
     bool getIsPaused() const { return m_isPaused; }
+    
+    // 性能统计面板，位于长度和按钮下方
+    // 可见性按面板自身的设置判断，HUD 隐藏时（如菜单界面）也能据此计算尺寸
+    void setProfilerVisible(bool visible);
+    bool isProfilerVisible() const { return !profilerLabel->isHidden(); }
+    void setProfilerText(const QString& text);
+
+    // 内存统计面板，位于性能统计下方
+    void setMemoryVisible(bool visible);
+    bool isMemoryVisible() const { return !memoryLabel->isHidden(); }
+    void setMemoryText(const QString& text);
+
+    static constexpr int BAR_HEIGHT = 50;
+    static constexpr int PROFILER_HEIGHT = 200;
+    static constexpr int MEMORY_HEIGHT = 420;
 
 signals:
     void pauseResumeClicked();
@@ -31,6 +46,8 @@ private:
     QLabel* lengthLabel;
     QPushButton* pauseResumeButton;
     QPushButton* restartButton;
+    QLabel* profilerLabel;
+    QLabel* memoryLabel;
     bool m_isPaused;
 };
 
@@ -40,6 +57,7 @@ class MenuWidget : public QOpenGLWidget, protected QOpenGLFunctions {
 public:
     explicit MenuWidget(QWidget *parent = nullptr);
     ~MenuWidget();
+    const GameWidget* getGameWidget() const { return gameWidget; }  // 菜单背景用的隐藏实例
 
 signals:
     void startGameClicked();
@@ -72,19 +90,28 @@ public:
     GameHUD* getGameHUD() { return gameHUD; }
     GameWidget* getGameWidget() { return gameWidget; }
 
+    // 汇总两个 GameWidget（菜单背景实例带 menu. 前缀）与共享的模型数据
+    MemoryReport collectMemoryReport() const;
+
+public slots:
+    void startGame();
+
 protected:
     void resizeEvent(QResizeEvent* event) override;
 
 private slots:
-    void startGame();
     void pauseResumeGame();
     void restartGame();
+    void updateHUDGeometry();
+    void updateMemoryOverlay();
 
 private:
     MenuWidget* menuWidget;
     GameWidget* gameWidget;
     GameHUD* gameHUD;
     MusicManager* musicManager;
+    QTimer* memoryTimer;
+    static constexpr int MEMORY_REPORT_INTERVAL = 500;  // 毫秒
 };
 
 #endif // UI_H 
\ No newline at end of file
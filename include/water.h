@@ -7,7 +7,12 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <vector>
+#include <cstdint>
+#include <map>
+#include <string>
 #include <QOpenGLFunctions>
+#include "rng.h"
+#include "memorystats.h"
 
 class Water : protected QOpenGLFunctions {
 public:
@@ -25,6 +30,17 @@ public:
     void renderWaterParticles();
     void setCameraPosition(const glm::vec3& pos);
     void updateWaterParticles(float deltaTime, const glm::vec3& snakePosition);
+    void setInterpolationAlpha(float alpha) { interpolationAlpha = alpha; }  // 渲染时在两次更新之间插值
+    void setSeed(uint64_t seed);  // 重新播种粒子、气泡和焦散的随机数流
+    void setMaxWaterParticles(int count);  // 水中颗粒上限，超出的部分立即丢弃
+    void reportMemory(MemoryReport& report) const;
+    static constexpr int MAX_WATER_PARTICLES = 1000;     // 默认的颗粒上限
+    
+    // 纹理数据的生成与上传分开，生成部分不需要GL上下文
+    std::vector<float> buildCausticTexture(int texSize);
+    static std::vector<unsigned char> buildWaterNormalTexture(int texSize);
+    static constexpr int CAUSTIC_TEXTURE_SIZE = 512;
+    static constexpr int NORMAL_TEXTURE_SIZE = 256;
     void renderWaterSurface(const glm::mat4& projection, const glm::mat4& view);
 
     // 添加获取水面高度的方法
@@ -90,6 +106,7 @@ public:
     // 添加水下颗粒结构体
     struct WaterParticle {
         glm::vec3 position;
+        glm::vec3 previousPosition;  // 上一次更新时的位置，用于渲染插值
         glm::vec3 velocity;
         glm::vec3 color;
         float size;
@@ -265,13 +282,16 @@ private:
     glm::mat4 projectionMatrix;  // 投影矩阵
     glm::mat4 viewMatrix;        // 视图矩阵
 
+    // 各纹理和缓冲区上传的字节数，按名称记录，重复上传时覆盖
+    void trackGpuMemory(const char* name, size_t bytes) { gpuAllocations[name] = bytes; }
+    std::map<std::string, size_t> gpuAllocations;
+
     // 添加私有函数
     void initParticleSystem();
     void spawnBubble();
     void updateBubble(Bubble& bubble, float deltaTime);
 
     // 水下颗粒系统参数
-    static constexpr int MAX_WATER_PARTICLES = 1000;     // 增加粒子数量
     static constexpr float PARTICLE_MIN_SIZE = 2.0f;     // 增加最小粒子尺寸
     static constexpr float PARTICLE_MAX_SIZE = 8.0f;     // 增加最大粒子尺寸
     static constexpr float PARTICLE_MIN_ALPHA = 0.3f;    // 增加最小透明度
@@ -283,8 +303,17 @@ private:
     static constexpr float PARTICLE_LIFE_MAX = 6.0f;     // 增加最大生命周期
     
     std::vector<WaterParticle> waterParticles;
+    size_t maxWaterParticles = MAX_WATER_PARTICLES;
+    std::vector<glm::vec3> particleJitter;   // 每次更新批量生成的粒子随机扰动
+    float interpolationAlpha = 1.0f;
     GLuint waterParticleTexture;
     
+    // 每个效果使用独立的随机数流，互不影响，也不与游戏逻辑共享状态
+    Rng particleRng{0, RngStream::WATER_PARTICLES};
+    Rng underwaterRng{0, RngStream::UNDERWATER_PARTICLES};
+    Rng bubbleRng{0, RngStream::BUBBLES};
+    Rng causticRng{0, RngStream::CAUSTICS};
+    
     void initWaterParticles();
     void generateWaterParticle(WaterParticle& particle, const glm::vec3& targetPos = glm::vec3(0.0f));
 };
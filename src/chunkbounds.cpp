@@ -0,0 +1,105 @@
+#include "chunkbounds.h"
+#include "snakebody.h"
+#include <algorithm>
+
+static ChunkBounds::Chunk makeEmptyChunk()
+{
+    ChunkBounds::Chunk chunk;
+    chunk.min = glm::vec3(0.0f);
+    chunk.max = glm::vec3(0.0f);
+    chunk.headSequence = 0;
+    chunk.count = 0;
+    chunk.dirty = false;
+    return chunk;
+}
+
+ChunkBounds::ChunkBounds()
+    : firstChunk(0)
+{
+}
+
+void ChunkBounds::clear()
+{
+    chunks.clear();
+    dirtyChunks.clear();
+    firstChunk = 0;
+}
+
+void ChunkBounds::markDirty(uint64_t sequence)
+{
+    uint64_t id = sequence >> CHUNK_SHIFT;
+    if(chunks.empty()) {
+        firstChunk = id;
+        chunks.push_back(makeEmptyChunk());
+    }
+
+    // 段序号连续，新组只会出现在两端
+    while(id < firstChunk) {
+        chunks.push_front(makeEmptyChunk());
+        --firstChunk;
+    }
+    while(id >= firstChunk + chunks.size()) {
+        chunks.push_back(makeEmptyChunk());
+    }
+    Chunk& chunk = chunks[static_cast<size_t>(id - firstChunk)];
+    if(!chunk.dirty) {
+        chunk.dirty = true;
+        dirtyChunks.push_back(id);
+    }
+}
+
+void ChunkBounds::refit(const SnakeBody& body)
+{
+    if(body.empty()) {
+        clear();
+        return;
+    }
+
+    const uint64_t headSeq = body.headSequence();
+    const uint64_t tailSeq = body.tailSequence();
+
+    for(uint64_t id : dirtyChunks) {
+        if(id < firstChunk || id >= firstChunk + chunks.size()) continue;
+        size_t c = static_cast<size_t>(id - firstChunk);
+        Chunk& chunk = chunks[c];
+        chunk.dirty = false;
+
+        // 组内仍存活的序号区间
+        uint64_t begin = std::max((firstChunk + c) << CHUNK_SHIFT, tailSeq);
+        uint64_t end = std::min(((firstChunk + c + 1) << CHUNK_SHIFT) - 1, headSeq);
+        if(begin > end) {
+            chunk.count = 0;
+            continue;
+        }
+
+        size_t firstIndex = body.indexOfSequence(end);
+        chunk.headSequence = end;
+        chunk.count = static_cast<size_t>(end - begin + 1);
+        chunk.min = chunk.max = body[firstIndex];
+        for(size_t i = 1; i < chunk.count; ++i) {
+            const glm::vec3& p = body[firstIndex + i];
+            chunk.min = glm::min(chunk.min, p);
+            chunk.max = glm::max(chunk.max, p);
+        }
+    }
+
+    dirtyChunks.clear();
+
+    // 移除两端的空组
+    while(!chunks.empty() && chunks.front().count == 0) {
+        chunks.pop_front();
+        ++firstChunk;
+    }
+    while(!chunks.empty() && chunks.back().count == 0) {
+        chunks.pop_back();
+    }
+}
+
+MemoryUsage ChunkBounds::memoryUsage() const
+{
+    // deque 的分块开销不计入
+    MemoryUsage usage;
+    usage.size = usage.capacity = chunks.size() * sizeof(Chunk);
+    usage += vectorMemory(dirtyChunks);
+    return usage;
+}
@@ -0,0 +1,300 @@
+#include <GL/glew.h>
+#include <QOpenGLFunctions>
+#include <QOpenGLContext>
+#include "foodrenderer.h"
+#include "spheremesh.h"
+#include "renderstats.h"
+#include "tracerecorder.h"
+#include "logging.h"
+
+// 食物替身的顶点着色器：把四边形放在球心所在、垂直于视线的平面上
+// 边长取视锥与该平面相交的圆的外接正方形，透视下也能完整覆盖球的轮廓
+const char* FoodRenderer::vertexShader = R"(
+    #version 330 compatibility
+    layout (location = 0) in vec2 aCorner;      // (±1, ±1)
+    layout (location = 1) in vec4 aInstance;    // xyz: 球心, w: 半径
+
+    out vec3 vRay;              // 眼空间中从相机指向四边形上该点的方向
+    flat out vec3 vCenter;
+    flat out float vRadius;
+
+    void main()
+    {
+        // 模型视图矩阵只含视图变换，不改变半径
+        vec3 center = (gl_ModelViewMatrix * vec4(aInstance.xyz, 1.0)).xyz;
+        float radius = aInstance.w;
+        float dist = length(center);
+        vCenter = center;
+        vRadius = radius;
+        if(dist <= radius) {
+            // 相机在球内，放到裁剪空间之外
+            vRay = vec3(0.0, 0.0, -1.0);
+            gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+            return;
+        }
+
+        vec3 view = center / dist;
+        vec3 up = abs(view.y) < 0.99 ? vec3(0.0, 1.0, 0.0) : vec3(1.0, 0.0, 0.0);
+        vec3 right = normalize(cross(up, view));
+        up = cross(view, right);
+        float extent = radius * dist / sqrt(dist * dist - radius * radius);
+
+        vec3 eyePos = center + (aCorner.x * right + aCorner.y * up) * extent;
+        vRay = eyePos;
+        gl_Position = gl_ProjectionMatrix * vec4(eyePos, 1.0);
+    }
+)";
+
+// 片段着色器：视线与球求交，未命中的像素丢弃，命中点写入深度并逐像素计算固定管线光源
+const char* FoodRenderer::fragmentShader = R"(
+    #version 330 compatibility
+    in vec3 vRay;
+    flat in vec3 vCenter;
+    flat in float vRadius;
+
+    uniform vec3 foodColor;
+    uniform int lightMask;      // 已启用光源的位掩码
+    uniform bool fogEnabled;
+
+    out vec4 FragColor;
+
+    void main()
+    {
+        // 用球心到视线的距离判断是否命中，避免大坐标下 b*b - c 的抵消误差
+        vec3 dir = normalize(vRay);
+        float b = dot(dir, vCenter);
+        vec3 offset = vCenter - b * dir;
+        float h = vRadius * vRadius - dot(offset, offset);
+        if(h < 0.0) discard;
+
+        vec3 eyePos = dir * (b - sqrt(h));
+        vec3 N = (eyePos - vCenter) / vRadius;
+        vec3 V = -dir;
+
+        vec4 clipPos = gl_ProjectionMatrix * vec4(eyePos, 1.0);
+        float ndcDepth = clipPos.z / clipPos.w;
+        gl_FragDepth = (gl_DepthRange.diff * ndcDepth + gl_DepthRange.near + gl_DepthRange.far) * 0.5;
+
+        vec3 color = gl_LightModel.ambient.rgb * foodColor;
+        for(int i = 0; i < 8; ++i) {
+            if((lightMask & (1 << i)) == 0) continue;
+
+            vec4 lightPos = gl_LightSource[i].position;
+            vec3 L;
+            float attenuation = 1.0;
+            if(lightPos.w == 0.0) {
+                L = normalize(lightPos.xyz);
+            } else {
+                vec3 toLight = lightPos.xyz - eyePos;
+                float dist = length(toLight);
+                L = toLight / dist;
+                attenuation = 1.0 / (gl_LightSource[i].constantAttenuation +
+                                     gl_LightSource[i].linearAttenuation * dist +
+                                     gl_LightSource[i].quadraticAttenuation * dist * dist);
+            }
+
+            float NdotL = max(dot(N, L), 0.0);
+            float spec = 0.0;
+            if(NdotL > 0.0) {
+                spec = pow(max(dot(N, normalize(L + V)), 0.0), gl_FrontMaterial.shininess);
+            }
+
+            color += attenuation * (gl_LightSource[i].ambient.rgb * foodColor +
+                                    gl_LightSource[i].diffuse.rgb * foodColor * NdotL +
+                                    gl_LightSource[i].specular.rgb * gl_FrontMaterial.specular.rgb * spec);
+        }
+
+        if(fogEnabled) {
+            float fogFactor = exp(-pow(gl_Fog.density * length(eyePos), 2.0));
+            color = mix(gl_Fog.color.rgb, color, clamp(fogFactor, 0.0, 1.0));
+        }
+
+        FragColor = vec4(color, 1.0);
+    }
+)";
+
+FoodRenderer::FoodRenderer()
+    : glContext(nullptr)
+    , program(0)
+    , cornerVBO(0)
+    , instanceVBO(0)
+    , uploadedRevision(0)
+    , uploaded(false)
+    , uploadedBytes(0)
+{
+}
+
+FoodRenderer::~FoodRenderer()
+{
+    releaseGL();
+}
+
+void FoodRenderer::initializeGL()
+{
+    releaseGL();
+    glContext = QOpenGLContext::currentContext();
+    if(!glContext) return;
+
+    initializeOpenGLFunctions();
+
+    // 实例化绘制需要 OpenGL 3.3
+    if(!glewIsSupported("GL_VERSION_3_3")) {
+        AQ_WARNING(lcGame) << "Food impostors not supported, falling back to sphere meshes";
+        return;
+    }
+
+    program = buildProgram();
+    if(!program) return;
+
+    const GLfloat corners[] = { -1.0f, -1.0f,  1.0f, -1.0f,  -1.0f, 1.0f,  1.0f, 1.0f };
+    glGenBuffers(1, &cornerVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, cornerVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    glGenBuffers(1, &instanceVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void FoodRenderer::releaseGL()
+{
+    // 只有在创建资源的上下文仍为当前上下文时才能安全删除
+    if(!glContext || QOpenGLContext::currentContext() != glContext) return;
+
+    if(program) glDeleteProgram(program);
+    if(cornerVBO) glDeleteBuffers(1, &cornerVBO);
+    if(instanceVBO) glDeleteBuffers(1, &instanceVBO);
+
+    program = 0;
+    cornerVBO = 0;
+    instanceVBO = 0;
+    uploaded = false;
+    uploadedBytes = 0;
+    glContext = nullptr;
+}
+
+GLuint FoodRenderer::buildProgram()
+{
+    AQ_TRACE_SCOPE("shader", "FoodRenderer::buildProgram");
+    GLint success;
+    GLchar infoLog[512];
+
+    GLuint vertex = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vertex, 1, &vertexShader, NULL);
+    glCompileShader(vertex);
+    glGetShaderiv(vertex, GL_COMPILE_STATUS, &success);
+    if(!success) {
+        glGetShaderInfoLog(vertex, 512, NULL, infoLog);
+        AQ_WARNING(lcGame) << "Food impostor vertex shader compilation failed:\n" << infoLog;
+        glDeleteShader(vertex);
+        return 0;
+    }
+
+    GLuint fragment = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(fragment, 1, &fragmentShader, NULL);
+    glCompileShader(fragment);
+    glGetShaderiv(fragment, GL_COMPILE_STATUS, &success);
+    if(!success) {
+        glGetShaderInfoLog(fragment, 512, NULL, infoLog);
+        AQ_WARNING(lcGame) << "Food impostor fragment shader compilation failed:\n" << infoLog;
+        glDeleteShader(vertex);
+        glDeleteShader(fragment);
+        return 0;
+    }
+
+    GLuint linked = glCreateProgram();
+    glAttachShader(linked, vertex);
+    glAttachShader(linked, fragment);
+    glLinkProgram(linked);
+    glDeleteShader(vertex);
+    glDeleteShader(fragment);
+
+    glGetProgramiv(linked, GL_LINK_STATUS, &success);
+    if(!success) {
+        glGetProgramInfoLog(linked, 512, NULL, infoLog);
+        AQ_WARNING(lcGame) << "Food impostor program linking failed:\n" << infoLog;
+        glDeleteProgram(linked);
+        return 0;
+    }
+    return linked;
+}
+
+void FoodRenderer::setShadingUniforms()
+{
+    GLint lightMask = 0;
+    for(int i = 0; i < 8; ++i) {
+        if(glIsEnabled(GL_LIGHT0 + i)) lightMask |= (1 << i);
+    }
+    glUniform1i(glGetUniformLocation(program, "lightMask"), lightMask);
+    glUniform1i(glGetUniformLocation(program, "fogEnabled"), glIsEnabled(GL_FOG) ? 1 : 0);
+    glUniform3f(glGetUniformLocation(program, "foodColor"), FOOD_COLOR_R, FOOD_COLOR_G, FOOD_COLOR_B);
+}
+
+void FoodRenderer::uploadInstances(const std::vector<Food>& foods, uint64_t revision)
+{
+    if(uploaded && revision == uploadedRevision) return;
+
+    instanceData.resize(foods.size());
+    for(size_t i = 0; i < foods.size(); ++i) {
+        instanceData[i].position = foods[i].getPosition();
+        instanceData[i].radius = foods[i].getSize();
+    }
+
+    uploadedBytes = instanceData.size() * sizeof(FoodInstance);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, uploadedBytes, instanceData.data(), GL_DYNAMIC_DRAW);
+    uploadedRevision = revision;
+    uploaded = true;
+}
+
+void FoodRenderer::draw(const std::vector<Food>& foods, uint64_t revision)
+{
+    if(!program) {
+        drawImmediate(foods);
+        return;
+    }
+    if(foods.empty()) return;
+
+    uploadInstances(foods, revision);
+
+    glUseProgram(program);
+    setShadingUniforms();
+
+    glBindBuffer(GL_ARRAY_BUFFER, cornerVBO);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), (void*)0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(FoodInstance), (void*)0);
+    glVertexAttribDivisor(1, 1);
+
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(instanceData.size()));
+    RenderStats::countDraw();
+
+    // 恢复状态，避免除数设置影响其他绘制
+    glVertexAttribDivisor(1, 0);
+    glDisableVertexAttribArray(0);
+    glDisableVertexAttribArray(1);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glUseProgram(0);
+}
+
+void FoodRenderer::drawImmediate(const std::vector<Food>& foods)
+{
+    glColor3f(FOOD_COLOR_R, FOOD_COLOR_G, FOOD_COLOR_B);
+    const SphereMesh& sphere = SphereMesh::get(FALLBACK_SPHERE_SECTORS, FALLBACK_SPHERE_STACKS);
+    for(const Food& food : foods) {
+        glm::vec3 position = food.getPosition();
+        glPushMatrix();
+        glTranslatef(position.x, position.y, position.z);
+        sphere.draw(food.getSize());
+        glPopMatrix();
+    }
+}
+
+void FoodRenderer::reportMemory(MemoryReport& report) const
+{
+    report.add("food.instances", vectorMemory(instanceData));
+    if(program) {
+        report.add("gpu.food.buffers", gpuMemory(uploadedBytes + 8 * sizeof(GLfloat)));
+    }
+}
@@ -0,0 +1,117 @@
+#include "foodspawnqueue.h"
+#include "tracerecorder.h"
+
+FoodSpawnQueue::FoodSpawnQueue()
+    : stopping(false)
+    , boundsMin(0.0f)
+    , boundsMax(0.0f)
+{
+}
+
+FoodSpawnQueue::~FoodSpawnQueue()
+{
+    stop();
+}
+
+void FoodSpawnQueue::reset(uint64_t seed, const glm::vec3& min, const glm::vec3& max,
+                           const std::vector<Obstacle>& newObstacles)
+{
+    stop();
+
+    // 线程已停止，不需要加锁
+    rng.seed(seed, static_cast<uint64_t>(RngStream::FOOD_SPAWN));
+    boundsMin = min;
+    boundsMax = max;
+    obstacles = newObstacles;
+    obstacleGrid.build(obstacles);
+    ready.clear();
+    stopping = false;
+}
+
+void FoodSpawnQueue::start(uint64_t seed, const glm::vec3& min, const glm::vec3& max,
+                           const std::vector<Obstacle>& newObstacles)
+{
+    reset(seed, min, max, newObstacles);
+    worker = std::thread(&FoodSpawnQueue::run, this);
+}
+
+void FoodSpawnQueue::stop()
+{
+    if(!worker.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    spaceAvailable.notify_all();
+    worker.join();
+}
+
+void FoodSpawnQueue::run()
+{
+    TraceRecorder::instance().setThreadName("food-spawn");
+
+    // 每生成一个候选就释放一次锁，取用方最多等待一个候选的生成时间
+    // 从开始补充到队列填满记为一条时间线事件
+    uint64_t refillStart = 0;
+    for(;;) {
+        std::unique_lock<std::mutex> lock(mutex);
+        spaceAvailable.wait(lock, [this] { return stopping || ready.size() < CAPACITY; });
+        if(stopping) break;
+        if(refillStart == 0) refillStart = TraceRecorder::now();
+        ready.push_back(generate());
+        if(ready.size() == CAPACITY) {
+            TraceRecorder::instance().record("world", "refillFoodQueue", refillStart, TraceRecorder::now());
+            refillStart = 0;
+        }
+    }
+}
+
+FoodSpawnQueue::Candidate FoodSpawnQueue::generate()
+{
+    Candidate candidate;
+    candidate.valid = false;
+    for(int dart = 0; dart < MAX_DARTS && !candidate.valid; ++dart) {
+        candidate.position = glm::vec3(rng.uniform(boundsMin.x, boundsMax.x),
+                                       rng.uniform(boundsMin.y, boundsMax.y),
+                                       rng.uniform(boundsMin.z, boundsMax.z));
+        candidate.valid = !obstacleGrid.visit(candidate.position, 0.0f, [this, &candidate](uint32_t index) {
+            return obstacles[index].checkCollision(candidate.position);
+        });
+    }
+    return candidate;
+}
+
+bool FoodSpawnQueue::pop(glm::vec3& position)
+{
+    Candidate candidate;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(ready.empty()) {
+            // 后台线程还没跟上（或未启动），按同一序列就地生成
+            candidate = generate();
+        } else {
+            candidate = ready.front();
+            ready.pop_front();
+        }
+    }
+    spaceAvailable.notify_one();
+    position = candidate.position;
+    return candidate.valid;
+}
+
+size_t FoodSpawnQueue::readyCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return ready.size();
+}
+
+MemoryUsage FoodSpawnQueue::memoryUsage() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    MemoryUsage usage;
+    usage.size = ready.size() * sizeof(Candidate);
+    usage.capacity = CAPACITY * sizeof(Candidate);
+    usage += vectorMemory(obstacles);
+    usage += obstacleGrid.memoryUsage();
+    return usage;
+}
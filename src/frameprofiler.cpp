@@ -0,0 +1,246 @@
+#include "frameprofiler.h"
+#include <algorithm>
+#include <cmath>
+
+static float elapsedMs(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+{
+    return std::chrono::duration<float, std::milli>(end - start).count();
+}
+
+FrameProfiler::FrameProfiler()
+    : enabled(false)
+    , gpuTimers(false)
+    , inFrame(false)
+    , activeQuery(-1)
+    , frameIndex(0)
+    , lastFrameStart()
+    , current()
+    , inFlight()
+    , queries()
+    , frameHistory(HISTORY_SIZE, 0.0f)
+    , historyCursor(0)
+    , historyCount(0)
+{
+    for(int i = 0; i < PHASE_COUNT; ++i) {
+        cpuHistory[i].assign(HISTORY_SIZE, 0.0f);
+        gpuHistory[i].assign(HISTORY_SIZE, 0.0f);
+    }
+}
+
+FrameProfiler::~FrameProfiler()
+{
+    closeCsv();
+}
+
+const char* FrameProfiler::phaseName(Phase phase)
+{
+    switch(phase) {
+        case UPDATE_GAME: return "updateGame";
+        case UPDATE_CAMERA: return "updateCamera";
+        case UPDATE_LIGHTS: return "updateLights";
+        case DRAW_AQUARIUM: return "drawAquarium";
+        case DRAW_SCENE_OBJECTS: return "drawSceneObjects";
+        case WATER_RENDER: return "Water::render";
+        case WATER_UNDERWATER: return "Water::renderUnderwaterEffects";
+        case WATER_PARTICLES: return "renderWaterParticles";
+        default: return "unknown";
+    }
+}
+
+void FrameProfiler::initializeGL()
+{
+    releaseGL();
+    gpuTimers = GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+    if(gpuTimers) {
+        glGenQueries(static_cast<GLsizei>(FRAME_LATENCY * PHASE_COUNT), &queries[0][0]);
+    }
+}
+
+void FrameProfiler::releaseGL()
+{
+    if(gpuTimers) {
+        glDeleteQueries(static_cast<GLsizei>(FRAME_LATENCY * PHASE_COUNT), &queries[0][0]);
+    }
+    gpuTimers = false;
+    activeQuery = -1;
+    for(FrameRecord& record : inFlight) {
+        record.pending = false;
+    }
+}
+
+void FrameProfiler::setEnabled(bool enable)
+{
+    if(enable == enabled) return;
+    enabled = enable;
+
+    // 重新开启时丢弃未取回的查询和半帧数据
+    inFrame = false;
+    current = FrameRecord();
+    lastFrameStart = std::chrono::steady_clock::time_point();
+    for(FrameRecord& record : inFlight) {
+        record.pending = false;
+    }
+}
+
+bool FrameProfiler::openCsv(const std::string& path)
+{
+    closeCsv();
+    csv.open(path, std::ios::trunc);
+    if(!csv) return false;
+
+    csv << "frame,frame_ms";
+    for(int i = 0; i < PHASE_COUNT; ++i) {
+        const char* name = phaseName(static_cast<Phase>(i));
+        csv << ',' << name << "_cpu_ms," << name << "_gpu_ms";
+    }
+    csv << '\n';
+    return static_cast<bool>(csv);
+}
+
+void FrameProfiler::closeCsv()
+{
+    if(csv.is_open()) csv.close();
+}
+
+void FrameProfiler::beginFrame()
+{
+    if(!enabled) return;
+
+    auto now = std::chrono::steady_clock::now();
+    current.frameTime = lastFrameStart == std::chrono::steady_clock::time_point() ? 0.0f : elapsedMs(lastFrameStart, now);
+    lastFrameStart = now;
+
+    // 按帧序取回已完成的查询，保证 CSV 按帧号递增
+    // 即将复用的查询槽位必须等到结果可读
+    if(gpuTimers) {
+        uint64_t oldest = frameIndex >= FRAME_LATENCY ? frameIndex - FRAME_LATENCY : 0;
+        for(uint64_t f = oldest; f < frameIndex; ++f) {
+            FrameRecord& record = inFlight[f % FRAME_LATENCY];
+            if(!record.pending || record.frame != f) continue;
+            resolveFrame(record, f == oldest && frameIndex >= FRAME_LATENCY);
+            if(record.pending) break;
+        }
+    }
+    inFrame = true;
+}
+
+void FrameProfiler::endFrame()
+{
+    if(!enabled || !inFrame) return;
+    inFrame = false;
+
+    current.frame = frameIndex;
+    current.pending = false;
+    for(int i = 0; i < PHASE_COUNT; ++i) {
+        current.pending = current.pending || current.queried[i];
+    }
+
+    if(current.pending) {
+        inFlight[frameIndex % FRAME_LATENCY] = current;
+    } else {
+        finishFrame(current);
+    }
+    current = FrameRecord();
+    ++frameIndex;
+}
+
+void FrameProfiler::beginPhase(Phase phase)
+{
+    phaseStart[phase] = std::chrono::steady_clock::now();
+
+    // 同一阶段一帧内多次执行时只查询第一次，CPU 时间累加
+    if(inFrame && gpuTimers && activeQuery < 0 && !current.queried[phase]) {
+        glBeginQuery(GL_TIME_ELAPSED, queries[frameIndex % FRAME_LATENCY][phase]);
+        activeQuery = phase;
+        current.queried[phase] = true;
+    }
+}
+
+void FrameProfiler::endPhase(Phase phase)
+{
+    if(activeQuery == phase) {
+        glEndQuery(GL_TIME_ELAPSED);
+        activeQuery = -1;
+    }
+    current.cpu[phase] += elapsedMs(phaseStart[phase], std::chrono::steady_clock::now());
+}
+
+void FrameProfiler::resolveFrame(FrameRecord& record, bool wait)
+{
+    size_t slot = record.frame % FRAME_LATENCY;
+    if(!wait) {
+        for(int i = 0; i < PHASE_COUNT; ++i) {
+            if(!record.queried[i]) continue;
+            GLuint available = 0;
+            glGetQueryObjectuiv(queries[slot][i], GL_QUERY_RESULT_AVAILABLE, &available);
+            if(!available) return;
+        }
+    }
+
+    for(int i = 0; i < PHASE_COUNT; ++i) {
+        if(!record.queried[i]) continue;
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(queries[slot][i], GL_QUERY_RESULT, &nanoseconds);
+        record.gpu[i] = static_cast<float>(nanoseconds / 1e6);
+    }
+    record.pending = false;
+    finishFrame(record);
+}
+
+void FrameProfiler::finishFrame(const FrameRecord& record)
+{
+    frameHistory[historyCursor] = record.frameTime;
+    for(int i = 0; i < PHASE_COUNT; ++i) {
+        cpuHistory[i][historyCursor] = record.cpu[i];
+        gpuHistory[i][historyCursor] = record.gpu[i];
+    }
+    historyCursor = (historyCursor + 1) % HISTORY_SIZE;
+    historyCount = std::min(historyCount + 1, HISTORY_SIZE);
+
+    if(csv.is_open()) {
+        csv << record.frame << ',' << record.frameTime;
+        for(int i = 0; i < PHASE_COUNT; ++i) {
+            csv << ',' << record.cpu[i] << ',' << record.gpu[i];
+        }
+        csv << '\n';
+    }
+}
+
+float FrameProfiler::average(const std::vector<float>& history, size_t count)
+{
+    if(count == 0) return 0.0f;
+    float sum = 0.0f;
+    for(size_t i = 0; i < count; ++i) {
+        sum += history[i];
+    }
+    return sum / count;
+}
+
+float FrameProfiler::percentile99(const std::vector<float>& history, size_t count)
+{
+    if(count == 0) return 0.0f;
+    std::vector<float> sorted(history.begin(), history.begin() + count);
+    size_t rank = static_cast<size_t>(std::ceil(count * 0.99)) - 1;
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+    return sorted[rank];
+}
+
+FrameProfiler::Stats FrameProfiler::getStats(Phase phase) const
+{
+    Stats stats;
+    stats.cpuAverage = average(cpuHistory[phase], historyCount);
+    stats.cpuP99 = percentile99(cpuHistory[phase], historyCount);
+    stats.gpuAverage = average(gpuHistory[phase], historyCount);
+    stats.gpuP99 = percentile99(gpuHistory[phase], historyCount);
+    return stats;
+}
+
+float FrameProfiler::getFrameAverage() const
+{
+    return average(frameHistory, historyCount);
+}
+
+float FrameProfiler::getFrameP99() const
+{
+    return percentile99(frameHistory, historyCount);
+}
@@ -0,0 +1,139 @@
+#include "frustumculler.h"
+
+#if defined(__AVX__)
+#define FRUSTUMCULLER_AVX 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FRUSTUMCULLER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+FrustumCuller::FrustumCuller()
+{
+    for(int i = 0; i < 6; ++i) {
+        planeX[i] = 0.0f;
+        planeY[i] = 0.0f;
+        planeZ[i] = 0.0f;
+        planeW[i] = 1.0f;
+    }
+}
+
+void FrustumCuller::setPlanes(const glm::vec4 planes[6])
+{
+    for(int i = 0; i < 6; ++i) {
+        planeX[i] = planes[i].x;
+        planeY[i] = planes[i].y;
+        planeZ[i] = planes[i].z;
+        planeW[i] = planes[i].w;
+    }
+}
+
+bool FrustumCuller::isSphereVisible(const glm::vec3& center, float radius) const
+{
+    for(int i = 0; i < 6; ++i) {
+        float distance = planeX[i] * center.x + planeY[i] * center.y + planeZ[i] * center.z + planeW[i];
+        if(distance < -radius) return false;
+    }
+    return true;
+}
+
+FrustumCuller::Containment FrustumCuller::classifyBox(const glm::vec3& boxMin, const glm::vec3& boxMax, float radius) const
+{
+    Containment result = INSIDE;
+    for(int i = 0; i < 6; ++i) {
+        // 盒内到平面距离最大和最小的角点
+        float maxDistance = planeW[i];
+        float minDistance = planeW[i];
+        maxDistance += planeX[i] * (planeX[i] >= 0.0f ? boxMax.x : boxMin.x);
+        minDistance += planeX[i] * (planeX[i] >= 0.0f ? boxMin.x : boxMax.x);
+        maxDistance += planeY[i] * (planeY[i] >= 0.0f ? boxMax.y : boxMin.y);
+        minDistance += planeY[i] * (planeY[i] >= 0.0f ? boxMin.y : boxMax.y);
+        maxDistance += planeZ[i] * (planeZ[i] >= 0.0f ? boxMax.z : boxMin.z);
+        minDistance += planeZ[i] * (planeZ[i] >= 0.0f ? boxMin.z : boxMax.z);
+
+        if(maxDistance < -radius) return OUTSIDE;
+        if(minDistance < -radius) result = INTERSECTING;
+    }
+    return result;
+}
+
+size_t FrustumCuller::cullScalar(const float* xs, const float* ys, const float* zs, size_t begin, size_t count,
+                                 float radius, uint32_t firstIndex, uint32_t* out) const
+{
+    size_t written = 0;
+    for(size_t i = begin; i < count; ++i) {
+        bool inside = true;
+        for(int p = 0; p < 6; ++p) {
+            float distance = planeX[p] * xs[i] + planeY[p] * ys[i] + planeZ[p] * zs[i] + planeW[p];
+            inside = inside && distance >= -radius;
+        }
+        out[written] = firstIndex + static_cast<uint32_t>(i);
+        written += inside ? 1 : 0;
+    }
+    return written;
+}
+
+size_t FrustumCuller::cull(const float* xs, const float* ys, const float* zs, size_t count,
+                           float radius, uint32_t firstIndex, std::vector<uint32_t>& visible) const
+{
+    if(count == 0) return 0;
+
+    // 先按最坏情况扩容，无分支地写入后再截断
+    const size_t offset = visible.size();
+    visible.resize(offset + count);
+    uint32_t* out = visible.data() + offset;
+    size_t written = 0;
+    size_t i = 0;
+
+#if defined(FRUSTUMCULLER_AVX)
+    const __m256 negRadius = _mm256_set1_ps(-radius);
+    for(; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_loadu_ps(xs + i);
+        __m256 y = _mm256_loadu_ps(ys + i);
+        __m256 z = _mm256_loadu_ps(zs + i);
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for(int p = 0; p < 6; ++p) {
+            __m256 d = _mm256_add_ps(
+                _mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(planeX[p])),
+                              _mm256_mul_ps(y, _mm256_set1_ps(planeY[p]))),
+                _mm256_add_ps(_mm256_mul_ps(z, _mm256_set1_ps(planeZ[p])),
+                              _mm256_set1_ps(planeW[p])));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, negRadius, _CMP_GE_OQ));
+        }
+        int mask = _mm256_movemask_ps(inside);
+        uint32_t base = firstIndex + static_cast<uint32_t>(i);
+        for(int lane = 0; lane < 8; ++lane) {
+            out[written] = base + lane;
+            written += (mask >> lane) & 1;
+        }
+    }
+#elif defined(FRUSTUMCULLER_SSE2)
+    const __m128 negRadius = _mm_set1_ps(-radius);
+    for(; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(xs + i);
+        __m128 y = _mm_loadu_ps(ys + i);
+        __m128 z = _mm_loadu_ps(zs + i);
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for(int p = 0; p < 6; ++p) {
+            __m128 d = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(planeX[p])),
+                           _mm_mul_ps(y, _mm_set1_ps(planeY[p]))),
+                _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(planeZ[p])),
+                           _mm_set1_ps(planeW[p])));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(d, negRadius));
+        }
+        int mask = _mm_movemask_ps(inside);
+        uint32_t base = firstIndex + static_cast<uint32_t>(i);
+        out[written] = base;     written += mask & 1;
+        out[written] = base + 1; written += (mask >> 1) & 1;
+        out[written] = base + 2; written += (mask >> 2) & 1;
+        out[written] = base + 3; written += (mask >> 3) & 1;
+    }
+#endif
+
+    // 剩余不足一组的部分（或无SIMD时的全部）
+    written += cullScalar(xs, ys, zs, i, count, radius, firstIndex, out + written);
+
+    visible.resize(offset + written);
+    return written;
+}
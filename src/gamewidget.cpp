@@ -4,18 +4,30 @@
 #include <chrono> 
 #include <glm/gtc/type_ptr.hpp>
 #include <GL/glew.h>
-#include "food.h"
+#include "obstaclerenderer.h"
 #include <QDebug>
+#include "logging.h"
+#include "renderstats.h"
 #include <QTime> 
+#include <algorithm>
+#include <random>
+#include <QFile>
+#include <QDateTime>
 
-static constexpr int INVINCIBLE_FRAMES_AFTER_FOOD = 20;    // 吃到食物后的无敌帧数
-static constexpr float FOOD_COLLISION_MULTIPLIER = 2.5f;   // 食物碰撞范围倍数
-static constexpr float OBSTACLE_COLLISION_MULTIPLIER = 0.7f; // 障碍物碰撞范围倍数
+SimulationConfig GameWidget::simulationConfig;
 
 GameWidget::GameWidget(QWidget *parent) 
     : QOpenGLWidget(parent)
     , water(nullptr)  // 初始化水体指针
-    , deltaTime(0.016f)  // 初始化时间步长(假设60fps)
+    , deltaTime(1.0f / DEFAULT_TICK_RATE)
+    , tickAccumulator(0.0)
+    , tickRate(DEFAULT_TICK_RATE)
+    , frameRateLimit(0)
+    , renderAlpha(1.0f)
+    , renderCameraPos(0.0f, DEFAULT_CAMERA_HEIGHT, DEFAULT_CAMERA_DISTANCE)
+    , tickCount(0)
+    , replayCursor(0)
+    , replaying(false)
     , gameTimer(nullptr)
     , rotationAngle(0.0f)
     , cameraDistance(DEFAULT_CAMERA_DISTANCE)    // 减小相机距离
@@ -26,13 +38,12 @@ GameWidget::GameWidget(QWidget *parent)
     , cameraTarget(0.0f, 0.0f, 0.0f)  // 看向原点
     , projectionMatrix(1.0f)
     , viewMatrix(1.0f)
-    , aquariumSize(AQUARIUM_DEFAULT_SIZE)  // 确保这个在使用前初始化
+    , aquariumSize(simulationConfig.aquariumSize)
     , isGameOver(false)
+    , world(aquariumSize)
     , waterLevel(0.0f)
     , waterShader(0)
     , gameState(GameState::READY)  // 改为 READY 状态
-    , score(0)
-    , invincibleFrames(0)  // 初始化无敌帧计数
     , currentHeight(CAMERA_SETTINGS.minHeight)
     , targetHeight(CAMERA_SETTINGS.minHeight)
     , currentFOV(CAMERA_SETTINGS.baseFOV)
@@ -49,55 +60,67 @@ GameWidget::GameWidget(QWidget *parent)
     , bubblePositions()  // 初始化气泡位置数组
     , currentCameraMode(CameraMode::FOLLOW)
 {
-    // 初始化定时器
+    // 初始化定时器：逻辑按固定步长推进，渲染频率与逻辑帧率无关
     gameTimer = new QTimer(this);
-    connect(gameTimer, &QTimer::timeout, this, [this]() {
-        if(gameState == GameState::PLAYING) {
-            updateGame();
-            updateCamera();
+    gameTimer->setTimerType(Qt::PreciseTimer);
+    connect(gameTimer, &QTimer::timeout, this, &GameWidget::advanceFrame);
+    
+    // 不限帧率时每帧交换后立即推进下一帧，由垂直同步决定实际帧率
+    connect(this, &QOpenGLWidget::frameSwapped, this, [this]() {
+        if(frameRateLimit == 0 && gameState == GameState::PLAYING) {
+            advanceFrame();
         }
-        update();
     });
     
-    // 确保边界已经设置好后再创建蛇
-    if(aquariumSize <= 0) {
-        aquariumSize = AQUARIUM_DEFAULT_SIZE;
-    }
+    // 尖刺球模型加载失败时只放置立方体障碍物
+    world.setSpikyObstaclesEnabled(ObstacleRenderer::loadSphereModel());
+    world.setFoodCount(simulationConfig.foodCount);
+    world.setObstacleCount(simulationConfig.obstacleCount);
+    world.reset(makeSeed());
     
     // 创建蛇，位置在水族箱左侧安全区域
     float startX = -aquariumSize * 0.4f;  // 从水族箱40%处开始
-    snake = new Snake(startX, 0.0f, 0.0f);
+    snake = new Snake(startX, 0.0f, 0.0f, simulationConfig.snakeLength);
     snake->setDirection(glm::vec3(1.0f, 0.0f, 0.0f));
 
     // 设置相机位置
     cameraTarget = snake->getHeadPosition();
     cameraPos = cameraTarget + glm::vec3(0.0f, 15.0f, 15.0f);
+    previousCameraPos = cameraPos;
+    previousCameraTarget = cameraTarget;
+    previousCameraRotation = currentCameraRotation;
 
     // 发送初始长度
-    emit lengthChanged(snake->getBody().size());
+    emit lengthChanged(snake->getLength());
 
-    // 生成食物
-    spawnFood();
+    // 生成障碍物和食物
+    world.initObstacles(snake->getHeadPosition());
+    world.spawnFood(snake);
     
     // 设置游戏状态
     gameState = GameState::PLAYING;
     
     // 启动定时器
-    gameTimer->start(16);
+    restartFrameClock();
+    gameTimer->start(timerInterval());
 
     // 调试输出
     glm::vec3 initialPos = snake->getHeadPosition();
-    qDebug() << "Initial setup -"
+    AQ_DEBUG(lcGame) << "Initial setup -"
              << "\nAquariumSize:" << aquariumSize
              << "\nMargin:" << (aquariumSize * 0.1f)
              << "\nSnake position:" << initialPos.x << initialPos.y << initialPos.z
-             << "\nIn bounds:" << isInAquarium(initialPos);
+             << "\nIn bounds:" << world.isInAquarium(initialPos);
 }
 
 GameWidget::~GameWidget()
 {
+    recorder.close(tickCount);
+    
     makeCurrent();
     
+    profiler.releaseGL();
+    foodRenderer.releaseGL();
     delete water;  
     
     // 清理纹理和FBO
@@ -114,9 +137,12 @@ GameWidget::~GameWidget()
 // 简化初始化，确保能看到场景
 void GameWidget::initializeGL()
 {
+    AQ_TRACE_SCOPE("asset", "GameWidget::initializeGL");
     // 首先化OpenGL函数
     initializeOpenGLFunctions();
     glewInit();
+    profiler.initializeGL();
+    foodRenderer.initializeGL();
 
     // 设置基本状态
     glClearColor(0.2f, 0.2f, 0.2f, 1.0f);
@@ -132,14 +158,11 @@ void GameWidget::initializeGL()
     GLfloat globalAmbient[] = { 0.4f, 0.4f, 0.4f, 1.0f };
     glLightModelfv(GL_LIGHT_MODEL_AMBIENT, globalAmbient);
 
-    // 初始化各个组件
-    initObstacles();
-    spawnFood();
-    
     // 设置初始相机位置
     cameraPos = glm::vec3(0.0f, 25.0f, 35.0f);
     cameraTarget = glm::vec3(0.0f);
     viewMatrix = glm::lookAt(cameraPos, cameraTarget, glm::vec3(0.0f, 1.0f, 0.0f));
+    renderCameraPos = cameraPos;
 
     // 初始化水体 - 确保在其他组件之后初始化
     if(water) {
@@ -147,6 +170,8 @@ void GameWidget::initializeGL()
         water = nullptr;
     }
     water = new Water(aquariumSize);
+    water->setMaxWaterParticles(simulationConfig.waterParticleCount);
+    water->setSeed(world.getSeed());  // 焦散纹理在 init 中生成，需先播种
     water->initializeGL();  // 确保调用水体的OpenGL初始化
     water->init();
     
@@ -155,12 +180,12 @@ void GameWidget::initializeGL()
     
     // 验证水体初始化
     if(water) {
-        qDebug() << "Water system initialized successfully";
-        qDebug() << "Aquarium size:" << aquariumSize;
+        AQ_DEBUG(lcGame) << "Water system initialized successfully";
+        AQ_DEBUG(lcGame) << "Aquarium size:" << aquariumSize;
         // 设置水体机位置
         water->setCameraPosition(cameraPos);
     } else {
-        qDebug() << "Failed to initialize water system!";
+        AQ_WARNING(lcGame) << "Failed to initialize water system!";
     }
 }
 
@@ -184,6 +209,8 @@ void GameWidget::resizeGL(int w, int h)
 
 // 打印蛇头位置和相机位置（用于调试）
 void GameWidget::paintGL() {
+    AQ_TRACE_SCOPE("frame", "paintGL");
+    profiler.beginFrame();
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     
     // 设置基本状态
@@ -193,7 +220,10 @@ void GameWidget::paintGL() {
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     
     // 更新光照
-    updateLights();
+    {
+        ProfileScope scope(profiler, FrameProfiler::UPDATE_LIGHTS);
+        updateLights();
+    }
     
     // 设置变换矩阵
     glMatrixMode(GL_PROJECTION);
@@ -202,7 +232,8 @@ void GameWidget::paintGL() {
     glLoadMatrixf(glm::value_ptr(viewMatrix));
     
     // 检查是否在水下，同时确保游戏状态为PLAYING
-    bool isUnderwater = water && gameState == GameState::PLAYING && water->isUnderwater(cameraPos);
+    // 用与 viewMatrix 相同的插值相机位置，穿过水面时与画面同步切换
+    bool isUnderwater = water && gameState == GameState::PLAYING && water->isUnderwater(renderCameraPos);
     
     if(isUnderwater && water) {
         // 在水下时，先应用水下效果
@@ -210,10 +241,16 @@ void GameWidget::paintGL() {
     }
     
     // 1. 绘制水族箱
-    drawAquarium();
+    {
+        ProfileScope scope(profiler, FrameProfiler::DRAW_AQUARIUM);
+        drawAquarium();
+    }
     
     // 2. 绘制场景对象
-    drawSceneObjects();
+    {
+        ProfileScope scope(profiler, FrameProfiler::DRAW_SCENE_OBJECTS);
+        drawSceneObjects();
+    }
     
     // 3. 渲染水体和水下效果
     if(water) {
@@ -222,15 +259,24 @@ void GameWidget::paintGL() {
         
         if(isUnderwater) {
             // 如果在水下，先渲染水下效果
-            water->renderUnderwaterEffects(projectionMatrix, viewMatrix);
+            {
+                ProfileScope scope(profiler, FrameProfiler::WATER_UNDERWATER);
+                water->renderUnderwaterEffects(projectionMatrix, viewMatrix);
+            }
             renderUnderwaterEffects(); // 渲染额外的水下效果
         }
         
         // 渲染水体表面
-        water->render(projectionMatrix, viewMatrix);
+        {
+            ProfileScope scope(profiler, FrameProfiler::WATER_RENDER);
+            water->render(projectionMatrix, viewMatrix);
+        }
         
         // 渲染粒子
-        water->renderWaterParticles();
+        {
+            ProfileScope scope(profiler, FrameProfiler::WATER_PARTICLES);
+            water->renderWaterParticles();
+        }
         
         // 恢复状态
         glPopAttrib();
@@ -242,6 +288,12 @@ void GameWidget::paintGL() {
     
     // 确保所有渲染完成
     glFlush();
+    
+    profiler.endFrame();
+    if(profiler.isEnabled() && profilerReportClock.elapsed() >= PROFILER_REPORT_INTERVAL) {
+        profilerReportClock.restart();
+        emit profilerReport(profilerReportText());
+    }
 }
 
 // 统一管理场景对象的绘制
@@ -256,26 +308,21 @@ void GameWidget::drawSceneObjects()
     glEnable(GL_COLOR_MATERIAL);
     
     // 绘制障碍物
-    for(const auto& obstacle : obstacles) {
+    for(const auto& obstacle : world.getObstacles()) {
         // 设置物体材质
         glColor4f(0.6f, 0.6f, 0.6f, 1.0f);  // 基础颜色
         GLfloat matSpecular[] = { 0.8f, 0.8f, 0.8f, 1.0f };
         glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, matSpecular);
         glMaterialf(GL_FRONT_AND_BACK, GL_SHININESS, 32.0f);
         
-        obstacle.draw();
+        ObstacleRenderer::draw(obstacle);
     }
 
-    //绘制食物
-    for(const auto& food : foods) {
-        // 设置物材质
-        glColor4f(1.0f, 0.5f, 0.0f, 1.0f);  // 橙色基础颜色
-        GLfloat foodSpecular[] = { 1.0f, 1.0f, 1.0f, 1.0f };
-        glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, foodSpecular);
-        glMaterialf(GL_FRONT_AND_BACK, GL_SHININESS, 64.0f);
-        
-        food.draw();
-    }
+    // 绘制食物，所有食物共用一种材质
+    GLfloat foodSpecular[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, foodSpecular);
+    glMaterialf(GL_FRONT_AND_BACK, GL_SHININESS, 64.0f);
+    foodRenderer.draw(world.getFoods(), world.getFoodRevision());
     
     // 绘制蛇
     if(snake) {
@@ -296,7 +343,7 @@ void GameWidget::drawSceneObjects()
 void GameWidget::keyPressEvent(QKeyEvent *event)
 {
     if (event->key() == Qt::Key_R) {
-        qDebug() << "Resetting game via R key";
+        AQ_DEBUG(lcGame) << "Resetting game via R key";
         resetGame();
         return;
     }
@@ -308,25 +355,48 @@ void GameWidget::keyPressEvent(QKeyEvent *event)
         return;
     }
 
-    if(gameState != GameState::PLAYING || !snake) return;
+    // 性能统计开关 (F3键)
+    if (event->key() == Qt::Key_F3) {
+        setProfilerEnabled(!profiler.isEnabled());
+        return;
+    }
+
+    // 内存统计面板开关 (F4键)
+    if (event->key() == Qt::Key_F4) {
+        setMemoryOverlayEnabled(!memoryOverlay);
+        return;
+    }
 
-    const float ROTATION_ANGLE = glm::radians(90.0f);
-    glm::vec3 currentDir = snake->getDirection();
-    glm::vec3 currentUp = snake->getUpDirection();
-    glm::vec3 currentRight = snake->getRightDirection();
+    // 导出最近一段时间的时间线 (F5键)
+    if (event->key() == Qt::Key_F5) {
+        saveTrace();
+        return;
+    }
 
+    // 切换蛇身渲染方式：球体串 / 连续管状网格 (T键)
+    if (event->key() == Qt::Key_T) {
+        if (snake) {
+            snake->setTubeRendering(!snake->isTubeRendering());
+        }
+        return;
+    }
+
+    // 回放期间转向只来自日志
+    if(gameState != GameState::PLAYING || !snake || replaying) return;
+
+    // 转向在下一个逻辑帧开始前生效
     switch(event->key()) {
         case Qt::Key_W:
-            snake->rotateAroundAxis(currentRight, ROTATION_ANGLE);
+            pendingInputs.push_back(InputCommand::TURN_UP);
             break;
         case Qt::Key_S:
-            snake->rotateAroundAxis(currentRight, -ROTATION_ANGLE);
+            pendingInputs.push_back(InputCommand::TURN_DOWN);
             break;
         case Qt::Key_A:
-            snake->rotateAroundAxis(currentUp, ROTATION_ANGLE);
+            pendingInputs.push_back(InputCommand::TURN_LEFT);
             break;
         case Qt::Key_D:
-            snake->rotateAroundAxis(currentUp, -ROTATION_ANGLE);
+            pendingInputs.push_back(InputCommand::TURN_RIGHT);
             break;
     }
 }
@@ -335,21 +405,14 @@ void GameWidget::updateGame()
 {
     if(gameState != GameState::PLAYING || !snake) return;
     
-    // 预判下一个位置
-    glm::vec3 nextPos = snake->getHeadPosition() + 
-                        glm::normalize(snake->getDirection()) * 
-                        snake->getMovementSpeed();
-    
-    // 如果下一个位置会出界，不移动蛇，等待新的输入
-    if(!isInAquarium(nextPos)) {
-        return;  // 直接返回，不结束游戏
+    // 移动、进食和碰撞判定由 GameWorld 完成，这里只处理界面和特效
+    GameWorld::TickResult result = world.tick(*snake);
+    if(!result.moved) {
+        return;  // 下一步会出界，蛇停在原地等待新的输入
     }
-
-    // 移动蛇
-    snake->move();
     
     // 更新并发送当前长度
-    emit lengthChanged(snake->getBody().size());
+    emit lengthChanged(snake->getLength());
     
     // 更新水体和粒子效果
     if (water) {
@@ -366,60 +429,283 @@ void GameWidget::updateGame()
         water->updateWaterParticles(deltaTime, particleSpawnPos);
     }
     
-    // 检查食物碰撞
-    bool foodEaten = false;
-    std::vector<size_t> foodToRemove;
+    // 如果吃到了食物
+    if(result.foodEaten > 0) {
+        emit scoreChanged(world.getScore());
+        emit lengthChanged(snake->getLength());
+    }
     
-    // 先检查所有需要移除的食物
-    for(size_t i = 0; i < foods.size(); ++i) {
-        float collisionDistance = snake->getSegmentSize() * FOOD_COLLISION_MULTIPLIER;
-        float distance = glm::distance(snake->getHeadPosition(), foods[i].getPosition());
-        
-        if (distance < collisionDistance) {
-            foodToRemove.push_back(i);
-            foodEaten = true;
+    if(result.collision != GameWorld::Collision::NONE) {
+        if(result.collision == GameWorld::Collision::OBSTACLE) {
+            AQ_DEBUG(lcGame) << "Game over! Collision with obstacle";
+        } else {
+            AQ_DEBUG(lcGame) << "Game over! Self collision";
         }
+        gameState = GameState::GAME_OVER;
+        isGameOver = true;
+        emit gameOver();
     }
     
-    // 如果吃到了食物
-    if(foodEaten) {
-        score += 10 * foodToRemove.size();
-        emit scoreChanged(score);
+    // 更新水体
+    if (water) {
+        water->update(deltaTime);
+    }
+}
+
+void GameWidget::advanceFrame()
+{
+    AQ_TRACE_SCOPE("frame", "advanceFrame");
+    // 本帧经过的真实时间，过长时截断
+    double elapsed = frameClock.nsecsElapsed() / 1e9;
+    frameClock.restart();
+    elapsed = std::min(elapsed, MAX_FRAME_TIME);
+    
+    // 游戏结束后不再推进逻辑帧，回放中的重置命令仍需在这里执行
+    if(gameState != GameState::PLAYING) {
+        applyInputs();
+    }
+    
+    if(gameState == GameState::PLAYING) {
+        tickAccumulator += elapsed;
+        const double tickInterval = 1.0 / tickRate;
         
-        // 从后向前移除食物
-        for(auto it = foodToRemove.rbegin(); it != foodToRemove.rend(); ++it) {
-            if(*it < foods.size()) {
-                foods.erase(foods.begin() + *it);
+        // 累积的时间足够几步就推进几步，逻辑结果与渲染帧率无关
+        while(tickAccumulator >= tickInterval) {
+            applyInputs();
+            if(gameState != GameState::PLAYING) {
+                tickAccumulator = 0.0;
+                break;
+            }
+            
+            if(snake) snake->storePreviousState();
+            previousCameraPos = cameraPos;
+            previousCameraTarget = cameraTarget;
+            previousCameraRotation = currentCameraRotation;
+            
+            {
+                ProfileScope scope(profiler, FrameProfiler::UPDATE_GAME);
+                updateGame();
+            }
+            {
+                ProfileScope scope(profiler, FrameProfiler::UPDATE_CAMERA);
+                updateCamera();
+            }
+            ++tickCount;
+            tickAccumulator -= tickInterval;
+            
+            if(gameState != GameState::PLAYING) {
+                tickAccumulator = 0.0;
+                break;
             }
         }
         
-        // 让蛇长
-        for(size_t i = 0; i < foodToRemove.size() * Snake::GROWTH_FACTOR; ++i) {
-            snake->grow();
+        renderAlpha = static_cast<float>(tickAccumulator / tickInterval);
+        applyRenderInterpolation();
+    }
+    
+    update();
+}
+
+void GameWidget::applyRenderInterpolation()
+{
+    // 相机平滑仍在逻辑帧中进行，这里只在上一帧与当前帧的结果之间插值
+    glm::vec3 eye = glm::mix(previousCameraPos, cameraPos, renderAlpha);
+    glm::vec3 target = glm::mix(previousCameraTarget, cameraTarget, renderAlpha);
+    glm::vec3 up = glm::vec3(0.0f, 0.0f, -1.0f);  // 俯视视角使用固定的世界空间上方
+    if(currentCameraMode == CameraMode::FOLLOW) {
+        glm::quat rotation = glm::slerp(previousCameraRotation, currentCameraRotation, renderAlpha);
+        up = glm::vec3(glm::mat4_cast(rotation) * glm::vec4(0.0f, 1.0f, 0.0f, 0.0f));
+    }
+    viewMatrix = glm::lookAt(eye, target, up);
+    renderCameraPos = eye;
+    
+    if(snake) {
+        snake->setRenderAlpha(renderAlpha);
+        snake->setViewMatrix(viewMatrix);
+    }
+    if(water) {
+        water->setInterpolationAlpha(renderAlpha);
+    }
+}
+
+void GameWidget::applyInputs()
+{
+    if(replaying) {
+        const std::vector<InputLog::Entry>& entries = replayLog.getEntries();
+        while(replayCursor < entries.size() && entries[replayCursor].tick <= tickCount) {
+            const InputLog::Entry& entry = entries[replayCursor++];
+            if(entry.command == InputCommand::RESET) {
+                resetSimulation(entry.seed);
+            } else if(snake) {
+                world.applyInput(*snake, entry.command);
+            }
         }
         
-        emit lengthChanged(snake->getBody().size());
-        
-        // 设置无敌帧
-        invincibleFrames = INVINCIBLE_FRAMES_AFTER_FOOD;
-        
-        // 生成新的食物
-        spawnFood();
+        // 日志结束后暂停，停在录制结束时的状态
+        bool finished = replayCursor >= entries.size() &&
+                        (tickCount >= replayLog.getEndTick() || gameState == GameState::GAME_OVER);
+        if(finished) {
+            AQ_DEBUG(lcGame) << "Replay finished at tick" << tickCount;
+            replaying = false;
+            pauseGame();
+        }
+        return;
     }
     
-    // 处理无敌帧
-    if(invincibleFrames > 0) {
-        invincibleFrames--;
-    } else {
-        checkCollisions();
+    for(InputCommand command : pendingInputs) {
+        if(recorder.isOpen()) {
+            recorder.record(tickCount, command);
+        }
+        if(snake) {
+            world.applyInput(*snake, command);
+        }
     }
+    pendingInputs.clear();
+}
+
+uint64_t GameWidget::makeSeed()
+{
+    std::random_device device;
+    return (static_cast<uint64_t>(device()) << 32) | device();
+}
+
+bool GameWidget::startRecording(const QString& path)
+{
+    if(replaying) return false;
     
-    // 更新水体
-    if (water) {
-        water->update(deltaTime);
+    uint64_t seed = makeSeed();
+    if(!recorder.open(QFile::encodeName(path).toStdString(), seed, tickRate, simulationConfig.scale())) {
+        AQ_WARNING(lcGame) << "Failed to open input recording:" << path;
+        return false;
+    }
+    AQ_DEBUG(lcGame) << "Recording input to" << path << "seed" << seed;
+    tickCount = 0;
+    resetSimulation(seed);
+    restartFrameClock();
+    return true;
+}
+
+bool GameWidget::startReplay(const QString& path)
+{
+    if(!replayLog.load(QFile::encodeName(path).toStdString())) {
+        AQ_WARNING(lcGame) << "Failed to load input recording:" << path;
+        return false;
+    }
+    // 世界在构造时已按当前配置建立，规模参数不同时无法复现录制时的模拟
+    if(replayLog.getScale() != simulationConfig.scale()) {
+        SimulationConfig recorded = simulationConfig;
+        recorded.applyScale(replayLog.getScale());
+        AQ_WARNING(lcGame) << "Input recording" << path << "was captured with"
+                           << QString::fromStdString(recorded.summary()) << "but the current scale is"
+                           << QString::fromStdString(simulationConfig.summary());
+        return false;
     }
+    AQ_DEBUG(lcGame) << "Replaying" << replayLog.getEntries().size() << "commands over"
+             << replayLog.getEndTick() << "ticks from" << path;
     
-    update();
+    // 逻辑结果与帧率无关，沿用录制时的帧率只是为了以相同速度观看
+    if(replayLog.getTickRate() > 0.0f) {
+        setTickRate(replayLog.getTickRate());
+    }
+    replaying = true;
+    resetGame();
+    return true;
+}
+
+void GameWidget::setProfilerEnabled(bool enable)
+{
+    if(enable == profiler.isEnabled()) return;
+    profiler.setEnabled(enable);
+    profilerReportClock.start();
+    emit profilerToggled(enable);
+}
+
+bool GameWidget::startProfilerCsv(const QString& path)
+{
+    if(!profiler.openCsv(path.toStdString())) {
+        AQ_WARNING(lcGame) << "Failed to open profiler CSV" << path;
+        return false;
+    }
+    setProfilerEnabled(true);
+    return true;
+}
+
+QString GameWidget::saveTrace()
+{
+    QString path = QString("aquasnake-trace-%1.json")
+        .arg(QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss"));
+    if(!TraceRecorder::instance().writeJson(QFile::encodeName(path).toStdString(), traceWindowSeconds)) {
+        AQ_WARNING(lcGame) << "Failed to write trace" << path;
+        return QString();
+    }
+    AQ_INFO(lcGame) << "Wrote last" << traceWindowSeconds << "seconds of trace events to" << path;
+    return path;
+}
+
+void GameWidget::reportMemory(MemoryReport& report) const
+{
+    if(snake) snake->reportMemory(report);
+    world.reportMemory(report);
+    foodRenderer.reportMemory(report);
+    if(water) water->reportMemory(report);
+}
+
+void GameWidget::setMemoryOverlayEnabled(bool enable)
+{
+    if(enable == memoryOverlay) return;
+    memoryOverlay = enable;
+    emit memoryOverlayToggled(enable);
+}
+
+QString GameWidget::profilerReportText() const
+{
+    QString text = QString::asprintf("%-30s %6.2f ms  p99 %6.2f ms\n",
+                                     "frame", profiler.getFrameAverage(), profiler.getFrameP99());
+    text += QString::asprintf("%-30s %15s  %15s\n", "", "cpu avg / p99", "gpu avg / p99");
+    for(int i = 0; i < FrameProfiler::PHASE_COUNT; ++i) {
+        FrameProfiler::Phase phase = static_cast<FrameProfiler::Phase>(i);
+        FrameProfiler::Stats stats = profiler.getStats(phase);
+        text += QString::asprintf("%-30s %6.2f / %6.2f", FrameProfiler::phaseName(phase),
+                                  stats.cpuAverage, stats.cpuP99);
+        if(profiler.hasGpuTimers()) {
+            text += QString::asprintf("  %6.2f / %6.2f", stats.gpuAverage, stats.gpuP99);
+        }
+        text += '\n';
+    }
+    return text.trimmed();
+}
+
+void GameWidget::restartFrameClock()
+{
+    frameClock.restart();
+    tickAccumulator = 0.0;
+}
+
+int GameWidget::timerInterval() const
+{
+    // 限制帧率时按帧率触发；否则定时器只按逻辑帧率保底推进，渲染由帧交换驱动
+    if(frameRateLimit > 0) {
+        return std::max(1, static_cast<int>(1000.0f / frameRateLimit));
+    }
+    return std::max(1, static_cast<int>(1000.0f / tickRate));
+}
+
+void GameWidget::setTickRate(float ticksPerSecond)
+{
+    if(ticksPerSecond <= 0.0f) return;
+    tickRate = ticksPerSecond;
+    deltaTime = 1.0f / tickRate;
+    if(gameTimer->isActive()) {
+        gameTimer->start(timerInterval());
+    }
+}
+
+void GameWidget::setFrameRateLimit(int fps)
+{
+    frameRateLimit = std::max(0, fps);
+    if(gameTimer->isActive()) {
+        gameTimer->start(timerInterval());
+    }
 }
 
 void GameWidget::updateCamera()
@@ -509,84 +795,6 @@ void GameWidget::updateCamera()
     }
 }
 
-void GameWidget::spawnFood()
-{
-    // 每次生成多个食物
-    int foodToSpawn = MIN_FOOD_COUNT - foods.size();
-    for (int i = 0; i < foodToSpawn; ++i) {
-        int maxAttempts = 100;
-        int attempts = 0;
-        glm::vec3 newFoodPos;
-        bool validPosition = false;
-        
-        do {
-            float range = aquariumSize * 0.8f;
-            newFoodPos = glm::vec3(
-                (float(rand()) / RAND_MAX * 2.0f - 1.0f) * range,
-                ((float(rand()) / RAND_MAX) - 0.5f) * range * 0.5f,
-                (float(rand()) / RAND_MAX * 2.0f - 1.0f) * range
-            );
-            
-            // 检查与其他食物的距离
-            bool tooClose = false;
-            for (const auto& existingFood : foods) {
-                if (glm::distance(newFoodPos, existingFood.getPosition()) < MIN_FOOD_DISTANCE) {
-                    tooClose = true;
-                    break;
-                }
-            }
-            
-            validPosition = !tooClose && isInAquarium(newFoodPos);
-            
-            // 检查与障碍物的碰撞
-            for(const auto& obstacle : obstacles) {
-                if(obstacle.checkCollision(newFoodPos)) {
-                    validPosition = false;
-                    break;
-                }
-            }
-            
-        } while (!validPosition && ++attempts < maxAttempts);
-
-        if (validPosition) {
-            foods.emplace_back(newFoodPos);
-        }
-    }
-}
-
-bool GameWidget::isValidFoodPosition(const glm::vec3& pos) const
-{
-    // 检查是否在水族箱内
-    if(!isInAquarium(pos)) return false;
-    
-    // 检查是否与障碍物重叠
-    for(const auto& obstacle : obstacles) {
-        if(obstacle.checkCollision(pos)) {
-            return false;
-        }
-    }
-    
-    // 检查是否与蛇重叠
-    if(snake->checkCollision(pos)) {
-        return false;
-    }
-    
-    return true;
-}
-
-bool GameWidget::isInAquarium(const glm::vec3& pos) const
-{
-    float margin = aquariumSize * 0.1f;  // 10%的边界预留量
-    float limit = aquariumSize - margin;
-    float heightLimit = limit * 0.5f;    // 高度限制为一半
-    
-    bool inX = pos.x >= -limit && pos.x <= limit;
-    bool inY = pos.y >= -heightLimit && pos.y <= heightLimit;
-    bool inZ = pos.z >= -limit && pos.z <= limit;
-
-    return inX && inY && inZ;
-}
-
 void GameWidget::drawAquarium()
 {
     // 绘制底面网格
@@ -600,6 +808,7 @@ void GameWidget::drawAquarium()
         glVertex3f(aquariumSize, -aquariumSize * 0.5f, i);
     }
     glEnd();
+    RenderStats::countDraw();
 
     // 绘制不透明的边界框
     glLineWidth(8.0f);  // 更粗的边界线
@@ -627,6 +836,7 @@ void GameWidget::drawAquarium()
     glVertex3f(-aquariumSize, -hs, aquariumSize); glVertex3f(-aquariumSize, hs, aquariumSize);
     glVertex3f(aquariumSize, -hs, aquariumSize); glVertex3f(aquariumSize, hs, aquariumSize);
     glEnd();
+    RenderStats::countDraw();
 
     // 修深度测试设置并绘制透明面
     glDepthMask(GL_FALSE);  // 禁用深度写入
@@ -637,7 +847,7 @@ void GameWidget::drawAquarium()
     hs = aquariumSize * 0.5f;
     
     // 判断相机是否在水族箱内
-    bool cameraInside = isInAquarium(cameraPos);
+    bool cameraInside = world.isInAquarium(cameraPos);
     
     // 相机在外部时将透明度降到更低
     float baseAlpha = cameraInside ? 0.2f : 0.02f;  // 降低外部时的透明度
@@ -751,6 +961,7 @@ void GameWidget::drawAquarium()
         }
     }
     glEnd();
+    RenderStats::countDraw();
     // 恢复OpenGL状态
     glEnable(GL_CULL_FACE);
     glDisable(GL_BLEND);
@@ -758,51 +969,61 @@ void GameWidget::drawAquarium()
     glLineWidth(1.0f);
 }
 
-void GameWidget::initObstacles()
+void GameWidget::resetGame()
 {
-    obstacles.clear();
-    for(int i = 0; i < MAX_OBSTACLES; ++i) {
-        float range = aquariumSize * 0.8f;
-        float x = (float(rand()) / RAND_MAX * 2.0f - 1.0f) * range;
-        float y = (float(rand()) / RAND_MAX * 2.0f - 1.0f) * range * 0.5f;
-        float z = (float(rand()) / RAND_MAX * 2.0f - 1.0f) * range;
-        
-        // 确保障会出现在蛇的初始位置附近
-        if(glm::length(glm::vec3(x, y, z) - snake->getHeadPosition()) < 100.0f) {
-            continue;
+    // 回放时重置游戏即从头重新回放
+    if(replaying) {
+        replayCursor = 0;
+        tickCount = 0;
+        resetSimulation(replayLog.getInitialSeed());
+    } else {
+        uint64_t seed = makeSeed();
+        if(recorder.isOpen()) {
+            recorder.record(tickCount, InputCommand::RESET, seed);
         }
-        
-        obstacles.emplace_back(glm::vec3(x, y, z), 50.0f);  // 增大障碍物尺寸
+        resetSimulation(seed);
     }
+    
+    // 重置前可能处于暂停，丢弃期间累积的时间
+    restartFrameClock();
 }
 
-void GameWidget::resetGame()
+void GameWidget::resetSimulation(uint64_t seed)
 {
-    qDebug() << "=== GAME RESET ===";
-    qDebug() << "Previous state:" << static_cast<int>(gameState);
+    AQ_DEBUG(lcGame) << "=== GAME RESET ===";
+    AQ_DEBUG(lcGame) << "Previous state:" << static_cast<int>(gameState);
 
     // 设置状态（只设置一次）
     gameState = GameState::PLAYING;
     isGameOver = false;
-    score = 0;
-    emit scoreChanged(score);
+    world.reset(seed);
+    if(water) water->setSeed(seed);
+    pendingInputs.clear();
+    emit scoreChanged(world.getScore());
     
-    qDebug() << "Game state reset to PLAYING:" << static_cast<int>(gameState);
+    AQ_DEBUG(lcGame) << "Game state reset to PLAYING:" << static_cast<int>(gameState);
 
-    // 删除旧的蛇并创建新的
+    // 删除旧的蛇并创建新的（蛇持有GL缓冲区，释放时需要当前上下文）
+    bool hasContext = context() && context()->isValid();
+    if (hasContext) {
+        makeCurrent();
+    }
+    bool tubeRendering = snake && snake->isTubeRendering();
     delete snake;
-    snake = new Snake(-5.0f, 0.0f, 0.0f);
-    emit lengthChanged(snake->getBody().size());
+    snake = new Snake(-5.0f, 0.0f, 0.0f, simulationConfig.snakeLength);
+    snake->setTubeRendering(tubeRendering);
+    emit lengthChanged(snake->getLength());
     
     // 如果OpenGL已初始化，则初始化蛇的OpenGL函数
-    if (context() && context()->isValid()) {
+    if (hasContext) {
         snake->initializeGL();
+        doneCurrent();
     }
     
     // 如果出界，移动到安全位置
     glm::vec3 newPos = snake->getHeadPosition();
-    if(!isInAquarium(newPos)) {
-        qDebug() << "WARNING: Reset position is out of bounds! Adjusting...";
+    if(!world.isInAquarium(newPos)) {
+        AQ_WARNING(lcGame) << "WARNING: Reset position is out of bounds! Adjusting...";
         newPos = glm::vec3(0.0f, 0.0f, 0.0f);
     }
 
@@ -811,54 +1032,25 @@ void GameWidget::resetGame()
     cameraTarget = snake->getHeadPosition();
     cameraAngle = CAMERA_DEFAULT_ANGLE;
 
-    // 重新生成食物
-    spawnFood();
+    // 重新初始化障碍物，再生成避开障碍物的食物
+    world.initObstacles(snake->getHeadPosition());
+    world.spawnFood(snake);
 
-    // 重新初始化障碍物
-    obstacles.clear();
-    initObstacles();
+    AQ_DEBUG(lcGame) << "New snake position:" << newPos.x << newPos.y << newPos.z
+             << "In bounds:" << world.isInAquarium(newPos);
 
-    qDebug() << "New snake position:" << newPos.x << newPos.y << newPos.z
-             << "In bounds:" << isInAquarium(newPos);
+    previousCameraPos = cameraPos;
+    previousCameraTarget = cameraTarget;
+    previousCameraRotation = currentCameraRotation;
 
     // 确保游戏计时器在运行
     if (!gameTimer->isActive()) {
-        gameTimer->start(16);
+        gameTimer->start(timerInterval());
     }
 
     update();
 }
 
-void GameWidget::checkCollisions()
-{
-    if(gameState != GameState::PLAYING || invincibleFrames > 0) return;
-    
-    const glm::vec3& headPos = snake->getHeadPosition();
-    
-    // 检查与障碍物的碰撞
-    for(const auto& obstacle : obstacles) {
-        float collisionDistance = glm::length(headPos - obstacle.getPosition());
-        float collisionRange = (snake->getSegmentSize() + obstacle.getRadius()) * OBSTACLE_COLLISION_MULTIPLIER;
-        
-        if(collisionDistance < collisionRange) {
-            qDebug() << "Game over! Collision with obstacle at distance:" << collisionDistance;
-            gameState = GameState::GAME_OVER;
-            isGameOver = true;
-            emit gameOver();
-            return;
-        }
-    }
-
-    // 检查与蛇身的碰撞
-    if(snake->checkSelfCollision()) {
-        qDebug() << "Game over! Self collision";
-        gameState = GameState::GAME_OVER;
-        isGameOver = true;
-        emit gameOver();
-        return;
-    }
-}
-
 void GameWidget::initLights() {
     lightSources.clear();
     
@@ -930,7 +1122,7 @@ void GameWidget::applyLightSettings() {
 
         // 设置光照颜色和强度
         float intensityFactor = light.intensity;
-        if(isInAquarium(cameraPos) && cameraPos.y < 0) {
+        if(world.isInAquarium(cameraPos) && cameraPos.y < 0) {
             // 水增强光照
             float depth = -cameraPos.y;
             float depthFactor = std::min(1.0f, depth / (aquariumSize * 0.5f));
@@ -996,7 +1188,7 @@ void GameWidget::updateLights() {
     }
 
     // 水下光照调整
-    if(water && isInAquarium(cameraPos)) {
+    if(water && world.isInAquarium(cameraPos)) {
         float depth = std::max(0.0f, water->getWaterHeight() - cameraPos.y);
         float depthFactor = std::min(1.0f, depth / (aquariumSize * 0.5f));
         
@@ -1033,7 +1225,7 @@ void GameWidget::renderUnderwaterEffects() {
     glFogi(GL_FOG_MODE, GL_EXP2);
     
     // 计算基于深度的雾效参数，但显著降低其影响
-    float depth = water->getWaterHeight() - cameraPos.y;
+    float depth = water->getWaterHeight() - renderCameraPos.y;
     float depthFactor = std::min(1.0f, depth * 0.0001f);  // 进一步降低深度影响
     
     // 使用更柔和的雾效颜色
@@ -1079,6 +1271,7 @@ void GameWidget::renderUnderwaterEffects() {
     glVertex2f( 1.0f,  1.0f);
     glVertex2f(-1.0f,  1.0f);
     glEnd();
+    RenderStats::countDraw();
     glEnable(GL_DEPTH_TEST);
     
     // 恢复矩阵
@@ -1123,6 +1316,7 @@ void GameWidget::applyUnderwaterState() {
     glVertex2f( 1.0f,  1.0f);
     glVertex2f(-1.0f,  1.0f);
     glEnd();
+    RenderStats::countDraw();
     glEnable(GL_DEPTH_TEST);
     
     glPopMatrix();
@@ -1148,17 +1342,8 @@ void GameWidget::resumeGame()
 {
     if(gameState == GameState::PAUSED) {
         gameState = GameState::PLAYING;
-        gameTimer->start(16);
+        restartFrameClock();
+        gameTimer->start(timerInterval());
         setFocus();  // 重新获得焦点
     }
-}
-
-// 在文件末尾添加 timerEvent 实现
-void GameWidget::timerEvent(QTimerEvent* event)
-{
-    if (gameState == GameState::PLAYING) {
-        updateGame();
-        updateCamera();
-        update();
-    }
 }
\ No newline at end of file
@@ -0,0 +1,253 @@
+#include "gameworld.h"
+#include "tracerecorder.h"
+#include <glm/gtx/rotate_vector.hpp>
+#include <algorithm>
+#include <functional>
+
+GameWorld::GameWorld(float aquariumSize)
+    : aquariumSize(aquariumSize > 0.0f ? aquariumSize : DEFAULT_AQUARIUM_SIZE)
+    , seed(0)
+    , foodRevision(0)
+    , score(0)
+    , invincibleFrames(0)
+    , foodCount(MIN_FOOD_COUNT)
+    , obstacleCount(MAX_OBSTACLES)
+    , spikyObstaclesEnabled(false)
+    , foodQueueWorkerEnabled(true)
+{
+    // 食物的生成范围：水平方向为水族箱的80%，高度方向再减半
+    const float range = this->aquariumSize * 0.8f;
+    foodSampler.reset(glm::vec3(-range, -range * 0.25f, -range), glm::vec3(range, range * 0.25f, range),
+                      MIN_FOOD_DISTANCE);
+}
+
+void GameWorld::reset(uint64_t newSeed)
+{
+    seed = newSeed;
+    rng.seed(newSeed, static_cast<uint64_t>(RngStream::WORLD));
+    foods.clear();
+    ++foodRevision;
+    foodSampler.clear();
+    obstacles.clear();
+    obstacleGrid.clear();
+    // 此时还没有障碍物，只重新播种；后台线程等 initObstacles 放置好障碍物后再启动
+    restartFoodQueue(false);
+    score = 0;
+    invincibleFrames = 0;
+}
+
+void GameWorld::restartFoodQueue(bool startWorker)
+{
+    const float range = aquariumSize * 0.8f;
+    const glm::vec3 min(-range, -range * 0.25f, -range), max(range, range * 0.25f, range);
+    if(startWorker) {
+        foodQueue.start(seed, min, max, obstacles);
+    } else {
+        foodQueue.reset(seed, min, max, obstacles);
+    }
+}
+
+void GameWorld::applyInput(SnakeCore& snake, InputCommand command) const
+{
+    const float ROTATION_ANGLE = glm::radians(90.0f);
+    switch(command) {
+        case InputCommand::TURN_UP:
+            snake.rotateAroundAxis(snake.getRightDirection(), ROTATION_ANGLE);
+            break;
+        case InputCommand::TURN_DOWN:
+            snake.rotateAroundAxis(snake.getRightDirection(), -ROTATION_ANGLE);
+            break;
+        case InputCommand::TURN_LEFT:
+            snake.rotateAroundAxis(snake.getUpDirection(), ROTATION_ANGLE);
+            break;
+        case InputCommand::TURN_RIGHT:
+            snake.rotateAroundAxis(snake.getUpDirection(), -ROTATION_ANGLE);
+            break;
+        default:
+            break;
+    }
+}
+
+GameWorld::TickResult GameWorld::tick(SnakeCore& snake)
+{
+    TickResult result;
+    
+    // 预判下一个位置
+    glm::vec3 nextPos = snake.getHeadPosition() + 
+                        glm::normalize(snake.getDirection()) * 
+                        snake.getMovementSpeed();
+    
+    // 如果下一个位置会出界，不移动蛇，等待新的输入
+    if(!isInAquarium(nextPos)) {
+        return result;  // 直接返回，不结束游戏
+    }
+
+    // 移动蛇
+    snake.move();
+    result.moved = true;
+    
+    // 检查食物碰撞，只查询蛇头附近的网格单元
+    const float collisionDistance = snake.getSegmentSize() * FOOD_COLLISION_MULTIPLIER;
+    const glm::vec3 head = snake.getHeadPosition();
+    eatenFoods.clear();
+    foodSampler.visit(head, collisionDistance, [&](size_t index, const glm::vec3& position) {
+        if(glm::distance(head, position) < collisionDistance) {
+            eatenFoods.push_back(index);
+        }
+    });
+
+    // 按下标从大到小交换弹出，末尾移来的食物不会是尚待移除的那些
+    std::sort(eatenFoods.begin(), eatenFoods.end(), std::greater<size_t>());
+    for(size_t index : eatenFoods) {
+        foodSampler.removeAt(index);
+        foods[index] = foods.back();
+        foods.pop_back();
+        ++result.foodEaten;
+    }
+    if(result.foodEaten > 0) ++foodRevision;
+    
+    // 如果吃到了食物
+    if(result.foodEaten > 0) {
+        score += 10 * result.foodEaten;
+        
+        // 让蛇长
+        for(int i = 0; i < result.foodEaten * SnakeCore::GROWTH_FACTOR; ++i) {
+            snake.grow();
+        }
+        
+        // 设置无敌帧
+        invincibleFrames = INVINCIBLE_FRAMES_AFTER_FOOD;
+        
+        // 生成新的食物
+        spawnFood(&snake);
+    }
+    
+    // 处理无敌帧
+    if(invincibleFrames > 0) {
+        invincibleFrames--;
+    } else {
+        result.collision = checkCollisions(snake);
+    }
+    
+    return result;
+}
+
+GameWorld::Collision GameWorld::checkCollisions(const SnakeCore& snake) const
+{
+    const glm::vec3 headPos = snake.getHeadPosition();
+    
+    // 检查与障碍物的碰撞，网格中登记的是障碍物的包围盒，查询半径只需加上蛇身部分
+    const float headRange = snake.getSegmentSize() * OBSTACLE_COLLISION_MULTIPLIER;
+    bool hitObstacle = obstacleGrid.visit(headPos, headRange, [&](uint32_t index) {
+        const Obstacle& obstacle = obstacles[index];
+        float collisionDistance = glm::length(headPos - obstacle.getPosition());
+        float collisionRange = (snake.getSegmentSize() + obstacle.getRadius()) * OBSTACLE_COLLISION_MULTIPLIER;
+        return collisionDistance < collisionRange;
+    });
+    if(hitObstacle) {
+        return Collision::OBSTACLE;
+    }
+
+    // 检查与蛇身的碰撞
+    if(snake.checkSelfCollision()) {
+        return Collision::SELF;
+    }
+    return Collision::NONE;
+}
+
+void GameWorld::spawnFood(const SnakeCore* snake)
+{
+    AQ_TRACE_SCOPE("world", "spawnFood");
+
+    // 泊松圆盘采样保证食物间距，只补足缺少的数量
+    // 一次采样失败说明空间已接近饱和，直接停止，留到下次吃掉食物后再补，避免长时间卡顿
+    auto accept = [this, snake](const glm::vec3& pos) {
+        return isInAquarium(pos) && !isInsideObstacle(pos) && !(snake && snake->checkCollision(pos));
+    };
+    int foodToSpawn = foodCount - static_cast<int>(foods.size());
+    for (int i = 0; i < foodToSpawn; ++i) {
+        // 预生成的候选已排除障碍物，这里只检查随时变化的食物间距和蛇身
+        glm::vec3 newFoodPos;
+        bool placed = false;
+        for (int attempt = 0; attempt < QUEUED_FOOD_ATTEMPTS && !placed; ++attempt) {
+            placed = foodQueue.pop(newFoodPos) && isInAquarium(newFoodPos) &&
+                     !(snake && snake->checkCollision(newFoodPos)) && foodSampler.insert(newFoodPos);
+        }
+        if (!placed && !foodSampler.sample(rng, MAX_FOOD_ATTEMPTS, accept, newFoodPos)) {
+            break;
+        }
+        foods.emplace_back(newFoodPos);
+        ++foodRevision;
+    }
+}
+
+void GameWorld::initObstacles(const glm::vec3& avoid)
+{
+    obstacles.clear();
+    for(int i = 0; i < obstacleCount; ++i) {
+        float range = aquariumSize * 0.8f;
+        float x = rng.signedUnit() * range;
+        float y = rng.signedUnit() * range * 0.5f;
+        float z = rng.signedUnit() * range;
+        
+        // 确保障碍物不会出现在蛇的初始位置附近
+        if(glm::length(glm::vec3(x, y, z) - avoid) < 100.0f) {
+            continue;
+        }
+        
+        Obstacle::Type type = Obstacle::Type::CUBE;
+        // 始终消耗一个随机数，模型是否加载不影响后续随机序列
+        bool spiky = rng.nextU32() & 1u;
+        if(spikyObstaclesEnabled && spiky) {
+            type = Obstacle::Type::SPIKY_SPHERE;
+        }
+        obstacles.emplace_back(glm::vec3(x, y, z), OBSTACLE_SIZE, type);
+    }
+    obstacleGrid.build(obstacles);
+    restartFoodQueue(foodQueueWorkerEnabled);
+}
+
+bool GameWorld::isValidFoodPosition(const glm::vec3& pos, const SnakeCore& snake) const
+{
+    // 检查是否在水族箱内
+    if(!isInAquarium(pos)) return false;
+    
+    // 检查是否与障碍物重叠
+    if(isInsideObstacle(pos)) return false;
+    
+    // 检查是否与蛇重叠
+    if(snake.checkCollision(pos)) {
+        return false;
+    }
+    
+    return true;
+}
+
+bool GameWorld::isInsideObstacle(const glm::vec3& pos) const
+{
+    return obstacleGrid.visit(pos, 0.0f, [&](uint32_t index) {
+        return obstacles[index].checkCollision(pos);
+    });
+}
+
+bool GameWorld::isInAquarium(const glm::vec3& pos) const
+{
+    float margin = aquariumSize * 0.1f;  // 10%的边界预留量
+    float limit = aquariumSize - margin;
+    float heightLimit = limit * 0.5f;    // 高度限制为一半
+    
+    bool inX = pos.x >= -limit && pos.x <= limit;
+    bool inY = pos.y >= -heightLimit && pos.y <= heightLimit;
+    bool inZ = pos.z >= -limit && pos.z <= limit;
+
+    return inX && inY && inZ;
+}
+
+void GameWorld::reportMemory(MemoryReport& report) const
+{
+    report.add("world.foods", vectorMemory(foods));
+    report.add("world.food_sampler", foodSampler.memoryUsage());
+    report.add("world.food_queue", foodQueue.memoryUsage());
+    report.add("world.obstacles", vectorMemory(obstacles));
+    report.add("world.obstacle_grid", obstacleGrid.memoryUsage());
+}
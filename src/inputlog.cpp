@@ -0,0 +1,176 @@
+#include "inputlog.h"
+#include <cstring>
+
+static const char LOG_MAGIC[4] = { 'A', 'Q', 'S', 'R' };
+static const uint16_t LOG_VERSION = 5;   // 头部记录规模参数，历史版本见 inputlog.h
+
+static bool readVarint(std::ifstream& in, uint64_t& value)
+{
+    value = 0;
+    for(int shift = 0; shift < 64; shift += 7) {
+        char byte;
+        if(!in.get(byte)) return false;
+        value |= static_cast<uint64_t>(static_cast<unsigned char>(byte) & 0x7f) << shift;
+        if(!(static_cast<unsigned char>(byte) & 0x80)) return true;
+    }
+    return false;
+}
+
+static bool readU32(std::ifstream& in, uint32_t& value)
+{
+    unsigned char bytes[4];
+    if(!in.read(reinterpret_cast<char*>(bytes), 4)) return false;
+    value = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+    return true;
+}
+
+static bool readFloat(std::ifstream& in, float& value)
+{
+    uint32_t bits;
+    if(!readU32(in, bits)) return false;
+    std::memcpy(&value, &bits, sizeof(value));
+    return true;
+}
+
+static bool readU64(std::ifstream& in, uint64_t& value)
+{
+    unsigned char bytes[8];
+    if(!in.read(reinterpret_cast<char*>(bytes), 8)) return false;
+    value = 0;
+    for(int i = 7; i >= 0; --i) {
+        value = (value << 8) | bytes[i];
+    }
+    return true;
+}
+
+InputLog::InputLog()
+    : initialSeed(0)
+    , tickRate(0.0f)
+    , scale{0.0f, 0, 0, 0}
+    , endTick(0)
+{
+}
+
+bool InputLog::load(const std::string& path)
+{
+    entries.clear();
+    endTick = 0;
+
+    std::ifstream in(path, std::ios::binary);
+    if(!in) return false;
+
+    char magic[4];
+    unsigned char version[2];
+    if(!in.read(magic, 4) || std::memcmp(magic, LOG_MAGIC, 4) != 0) return false;
+    if(!in.read(reinterpret_cast<char*>(version), 2)) return false;
+    if((version[0] | (version[1] << 8)) != LOG_VERSION) return false;
+    if(!readFloat(in, tickRate)) return false;
+    if(!readU64(in, initialSeed)) return false;
+    if(!readFloat(in, scale.aquariumSize)) return false;
+    if(!readU32(in, scale.obstacleCount)) return false;
+    if(!readU32(in, scale.foodCount)) return false;
+    if(!readU32(in, scale.snakeLength)) return false;
+
+    // 录制被意外中断时没有 END 记录，以最后一条命令所在的帧为结尾
+    uint64_t tick = 0;
+    uint64_t delta;
+    while(readVarint(in, delta)) {
+        char command;
+        if(!in.get(command)) break;
+        tick += delta;
+
+        Entry entry;
+        entry.tick = tick;
+        entry.command = static_cast<InputCommand>(static_cast<unsigned char>(command));
+        entry.seed = 0;
+        if(entry.command > InputCommand::END) return false;
+        if(entry.command == InputCommand::END) {
+            endTick = tick;
+            return true;
+        }
+        if(entry.command == InputCommand::RESET && !readU64(in, entry.seed)) break;
+        entries.push_back(entry);
+        endTick = tick;
+    }
+    return true;
+}
+
+InputRecorder::InputRecorder()
+    : lastTick(0)
+{
+}
+
+InputRecorder::~InputRecorder()
+{
+    if(file.is_open()) close(lastTick);
+}
+
+bool InputRecorder::open(const std::string& path, uint64_t initialSeed, float tickRate,
+                         const SimulationScale& scale)
+{
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if(!file) return false;
+
+    uint32_t rateBits, sizeBits;
+    std::memcpy(&rateBits, &tickRate, sizeof(rateBits));
+    std::memcpy(&sizeBits, &scale.aquariumSize, sizeof(sizeBits));
+    const unsigned char version[2] = { LOG_VERSION & 0xff, LOG_VERSION >> 8 };
+    file.write(LOG_MAGIC, 4);
+    file.write(reinterpret_cast<const char*>(version), sizeof(version));
+    writeU32(rateBits);
+    writeU64(initialSeed);
+    writeU32(sizeBits);
+    writeU32(scale.obstacleCount);
+    writeU32(scale.foodCount);
+    writeU32(scale.snakeLength);
+    file.flush();
+    lastTick = 0;
+    return static_cast<bool>(file);
+}
+
+void InputRecorder::record(uint64_t tick, InputCommand command, uint64_t seed)
+{
+    if(!file.is_open()) return;
+
+    writeVarint(tick - lastTick);
+    file.put(static_cast<char>(command));
+    if(command == InputCommand::RESET) {
+        writeU64(seed);
+    }
+    file.flush();
+    lastTick = tick;
+}
+
+void InputRecorder::close(uint64_t endTick)
+{
+    if(!file.is_open()) return;
+    record(endTick < lastTick ? lastTick : endTick, InputCommand::END);
+    file.close();
+}
+
+void InputRecorder::writeVarint(uint64_t value)
+{
+    while(value >= 0x80) {
+        file.put(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    file.put(static_cast<char>(value));
+}
+
+void InputRecorder::writeU32(uint32_t value)
+{
+    unsigned char bytes[4];
+    for(int i = 0; i < 4; ++i) {
+        bytes[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+    file.write(reinterpret_cast<const char*>(bytes), 4);
+}
+
+void InputRecorder::writeU64(uint64_t value)
+{
+    unsigned char bytes[8];
+    for(int i = 0; i < 8; ++i) {
+        bytes[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+    file.write(reinterpret_cast<const char*>(bytes), 8);
+}
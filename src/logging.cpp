@@ -0,0 +1,6 @@
+#include "logging.h"
+
+Q_LOGGING_CATEGORY(lcGame, "aquasnake.game")
+Q_LOGGING_CATEGORY(lcWater, "aquasnake.water")
+Q_LOGGING_CATEGORY(lcParticles, "aquasnake.water.particles")
+Q_LOGGING_CATEGORY(lcBubbles, "aquasnake.water.bubbles")
@@ -1,13 +1,169 @@
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QLoggingCategory>
+#include <QFile>
+#include <cstring>
+#include <utility>
 #include "ui.h"
+#include "gamewidget.h"
+#include "renderbenchmark.h"
+#include "tracerecorder.h"
+#include "inputlog.h"
+
+// 渲染基准测试不需要显示器，须在创建 QApplication 之前选择平台插件
+// offscreen 插件不支持 GL 时可改用 QT_QPA_PLATFORM=eglfs 或在 xvfb-run 下运行
+static void selectOffscreenPlatform(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--render-benchmark", 18) == 0) {
+            if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+                qputenv("QT_QPA_PLATFORM", "offscreen");
+            }
+            return;
+        }
+    }
+}
+
+static QString joinNames(const std::vector<std::string>& names)
+{
+    QStringList list;
+    for (const std::string& name : names) {
+        list << QString::fromStdString(name);
+    }
+    return list.join(", ");
+}
 
 int main(int argc, char *argv[])
 {
+    selectOffscreenPlatform(argc, argv);
     QApplication app(argc, argv);
+    TraceRecorder::instance().setThreadName("main");
+    
+    // 命令行选项：录制输入，或回放录制的输入以复现性能问题
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption recordOption("record", "Record simulation input to <file>.", "file");
+    QCommandLineOption replayOption("replay", "Replay simulation input from <file>.", "file");
+    QCommandLineOption profileCsvOption("profile-csv", "Write per-frame phase timings to <file>.", "file");
+    QCommandLineOption logRulesOption("log-rules",
+        "Logging filter rules separated by ';', e.g. \"aquasnake.water.particles.debug=false\".", "rules");
+    QCommandLineOption traceWindowOption("trace-window",
+        "Seconds of timeline events written by F5 as Chrome trace JSON (default 10).", "seconds");
+    QCommandLineOption memoryJsonOption("memory-json", "Write per-subsystem memory usage to <file> on exit.", "file");
+    QCommandLineOption renderBenchmarkOption("render-benchmark",
+        "Render <frames> frames offscreen along a scripted camera path, print statistics and exit.", "frames");
+    QCommandLineOption renderSizeOption("render-size", "Framebuffer size for --render-benchmark (default 1280x720).", "WxH");
+    parser.addOption(recordOption);
+    parser.addOption(replayOption);
+    parser.addOption(profileCsvOption);
+    parser.addOption(logRulesOption);
+    parser.addOption(traceWindowOption);
+    parser.addOption(memoryJsonOption);
+    parser.addOption(renderBenchmarkOption);
+    parser.addOption(renderSizeOption);
+    
+    // 规模参数：先应用预设，再读配置文件，最后是单项选项
+    QCommandLineOption presetOption("preset",
+        "Scale preset: " + joinNames(SimulationConfig::presetNames()) + ".", "name");
+    QCommandLineOption configOption("config",
+        "Read scale settings from a key=value <file>; keys: preset, " + joinNames(SimulationConfig::keys()) + ".", "file");
+    QCommandLineOption aquariumSizeOption("aquarium-size", "Aquarium half extent.", "size");
+    QCommandLineOption obstaclesOption("obstacles", "Number of obstacles.", "count");
+    QCommandLineOption foodOption("food", "Number of food items kept in the aquarium.", "count");
+    QCommandLineOption waterParticlesOption("water-particles", "Maximum number of water particles.", "count");
+    QCommandLineOption snakeLengthOption("snake-length", "Initial snake length.", "length");
+    parser.addOption(presetOption);
+    parser.addOption(configOption);
+    parser.addOption(aquariumSizeOption);
+    parser.addOption(obstaclesOption);
+    parser.addOption(foodOption);
+    parser.addOption(waterParticlesOption);
+    parser.addOption(snakeLengthOption);
+    parser.process(app);
+    
+    SimulationConfig config;
+    std::string configError;
+    bool configOk = true;
+    if (parser.isSet(presetOption)) {
+        configOk = config.applyPreset(parser.value(presetOption).toStdString(), configError);
+    }
+    if (configOk && parser.isSet(configOption)) {
+        configOk = config.loadFile(QFile::encodeName(parser.value(configOption)).toStdString(), configError);
+    }
+    const std::pair<const QCommandLineOption*, const char*> overrides[] = {
+        { &aquariumSizeOption, "aquarium_size" },
+        { &obstaclesOption, "obstacles" },
+        { &foodOption, "food" },
+        { &waterParticlesOption, "water_particles" },
+        { &snakeLengthOption, "snake_length" },
+    };
+    for (const auto& entry : overrides) {
+        if (configOk && parser.isSet(*entry.first)) {
+            configOk = config.set(entry.second, parser.value(*entry.first).toStdString(), configError);
+        }
+    }
+    if (!configOk) {
+        qCritical().noquote() << "Invalid scale configuration:" << QString::fromStdString(configError);
+        return 1;
+    }
+    
+    // 回放时使用录制时的规模参数，须在创建 GameWidget 之前设置；无法读取时由 startReplay 报错
+    if (parser.isSet(replayOption)) {
+        InputLog recording;
+        if (recording.load(QFile::encodeName(parser.value(replayOption)).toStdString()) &&
+            recording.getScale() != config.scale()) {
+            config.applyScale(recording.getScale());
+            qInfo().noquote() << "Using the scale stored in the recording:" << QString::fromStdString(config.summary());
+        }
+    }
+    GameWidget::setSimulationConfig(config);
+    
+    if (parser.isSet(logRulesOption)) {
+        QLoggingCategory::setFilterRules(parser.value(logRulesOption).replace(';', '\n'));
+    } else if (parser.isSet(renderBenchmarkOption)) {
+        // 逐帧的调试输出会影响计时
+        QLoggingCategory::setFilterRules("aquasnake.*.debug=false");
+    }
+    
+    if (parser.isSet(renderBenchmarkOption)) {
+        RenderBenchmark::Options options;
+        options.frames = parser.value(renderBenchmarkOption).toInt();
+        if (parser.isSet(renderSizeOption)) {
+            QStringList size = parser.value(renderSizeOption).split('x');
+            options.width = size.value(0).toInt();
+            options.height = size.value(1).toInt();
+        }
+        return RenderBenchmark(options).run();
+    }
     
     UIManager mainWindow;
     mainWindow.setMinimumSize(1024, 768);
     mainWindow.show();
     
-    return app.exec();
-}
\ No newline at end of file
+    GameWidget* gameWidget = mainWindow.getGameWidget();
+    if (parser.isSet(traceWindowOption)) {
+        gameWidget->setTraceWindow(parser.value(traceWindowOption).toDouble());
+    }
+    if (parser.isSet(profileCsvOption)) {
+        gameWidget->startProfilerCsv(parser.value(profileCsvOption));
+    }
+    if (parser.isSet(replayOption)) {
+        // 回放直接进入游戏界面
+        if (gameWidget->startReplay(parser.value(replayOption))) {
+            mainWindow.startGame();
+        }
+    } else if (parser.isSet(recordOption)) {
+        gameWidget->startRecording(parser.value(recordOption));
+    }
+    
+    int exitCode = app.exec();
+    
+    // 退出时两个 GameWidget 仍然存在，此时的统计包含最终状态
+    if (parser.isSet(memoryJsonOption)) {
+        QString path = parser.value(memoryJsonOption);
+        if (!mainWindow.collectMemoryReport().writeJson(QFile::encodeName(path).toStdString())) {
+            qWarning() << "Failed to write memory report" << path;
+        }
+    }
+    return exitCode;
+}
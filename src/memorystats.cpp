@@ -0,0 +1,94 @@
+#include "memorystats.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+void MemoryReport::add(const std::string& name, const MemoryUsage& usage)
+{
+    // 同名条目累加，多个对象可以汇总到同一项
+    for(Entry& entry : entries) {
+        if(entry.name == name) {
+            entry.usage += usage;
+            return;
+        }
+    }
+    entries.push_back(Entry{name, usage});
+}
+
+void MemoryReport::append(const std::string& prefix, const MemoryReport& other)
+{
+    for(const Entry& entry : other.entries) {
+        add(prefix + entry.name, entry.usage);
+    }
+}
+
+MemoryUsage MemoryReport::total() const
+{
+    MemoryUsage sum;
+    for(const Entry& entry : entries) {
+        sum += entry.usage;
+    }
+    return sum;
+}
+
+std::string MemoryReport::formatBytes(size_t bytes)
+{
+    char text[32];
+    if(bytes >= 1024 * 1024) {
+        std::snprintf(text, sizeof(text), "%.2f MiB", bytes / (1024.0 * 1024.0));
+    } else if(bytes >= 1024) {
+        std::snprintf(text, sizeof(text), "%.1f KiB", bytes / 1024.0);
+    } else {
+        std::snprintf(text, sizeof(text), "%zu B", bytes);
+    }
+    return text;
+}
+
+std::string MemoryReport::toText() const
+{
+    size_t width = 5;
+    for(const Entry& entry : entries) {
+        width = std::max(width, entry.name.size());
+    }
+
+    std::string text;
+    char line[256];
+    auto appendLine = [&](const std::string& name, const MemoryUsage& usage) {
+        std::snprintf(line, sizeof(line), "%-*s %12s / %12s\n", static_cast<int>(width), name.c_str(),
+                      formatBytes(usage.size).c_str(), formatBytes(usage.capacity).c_str());
+        text += line;
+    };
+    std::snprintf(line, sizeof(line), "%-*s %12s / %12s\n", static_cast<int>(width), "", "size", "capacity");
+    text += line;
+    for(const Entry& entry : entries) {
+        appendLine(entry.name, entry.usage);
+    }
+    appendLine("total", total());
+    return text;
+}
+
+std::string MemoryReport::toJson() const
+{
+    // 名称只含字母、数字、点和下划线，无需转义
+    std::ostringstream out;
+    MemoryUsage sum = total();
+    out << "{\n  \"total\": {\"size\": " << sum.size << ", \"capacity\": " << sum.capacity << "},\n"
+        << "  \"subsystems\": [";
+    for(size_t i = 0; i < entries.size(); ++i) {
+        const Entry& entry = entries[i];
+        out << (i == 0 ? "\n" : ",\n")
+            << "    {\"name\": \"" << entry.name << "\", \"size\": " << entry.usage.size
+            << ", \"capacity\": " << entry.usage.capacity << "}";
+    }
+    out << "\n  ]\n}\n";
+    return out.str();
+}
+
+bool MemoryReport::writeJson(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::trunc);
+    if(!file) return false;
+    file << toJson();
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,78 @@
+#include "obstaclegrid.h"
+
+ObstacleGrid::ObstacleGrid()
+    : origin(0.0f)
+    , cellSize(1.0f)
+    , invCellSize(1.0f)
+    , dims{0, 0, 0}
+{
+}
+
+void ObstacleGrid::clear()
+{
+    cellStart.clear();
+    items.clear();
+    dims[0] = dims[1] = dims[2] = 0;
+}
+
+void ObstacleGrid::build(const std::vector<Obstacle>& obstacles)
+{
+    clear();
+    if(obstacles.empty()) return;
+
+    glm::vec3 lo(INFINITY), hi(-INFINITY);
+    float maxRadius = 0.0f;
+    for(const Obstacle& obstacle : obstacles) {
+        float r = boundingRadius(obstacle);
+        lo = glm::min(lo, obstacle.getPosition() - glm::vec3(r));
+        hi = glm::max(hi, obstacle.getPosition() + glm::vec3(r));
+        maxRadius = std::max(maxRadius, r);
+    }
+
+    // 单元边长取平均每单元约一个障碍物，且不小于障碍物直径，避免一个障碍物占据过多单元
+    const glm::vec3 extent = glm::max(hi - lo, glm::vec3(1.0f));
+    float volume = extent.x * extent.y * extent.z;
+    cellSize = std::max(2.0f * maxRadius, std::cbrt(volume / obstacles.size()));
+    for(;;) {
+        for(int axis = 0; axis < 3; ++axis) {
+            dims[axis] = std::max(1, static_cast<int>(std::ceil(extent[axis] / cellSize)));
+        }
+        if(static_cast<size_t>(dims[0]) * dims[1] * dims[2] <= MAX_CELLS) break;
+        cellSize *= 1.25f;
+    }
+    invCellSize = 1.0f / cellSize;
+    origin = lo;
+
+    // 第一遍统计每个单元的障碍物数，前缀和得到偏移，第二遍填入下标
+    cellStart.assign(static_cast<size_t>(dims[0]) * dims[1] * dims[2] + 1, 0);
+    auto forEachCell = [this](const Obstacle& obstacle, auto fn) {
+        float r = boundingRadius(obstacle);
+        glm::vec3 p = obstacle.getPosition();
+        for(int z = cellCoord(p.z - r, 2); z <= cellCoord(p.z + r, 2); ++z) {
+            for(int y = cellCoord(p.y - r, 1); y <= cellCoord(p.y + r, 1); ++y) {
+                for(int x = cellCoord(p.x - r, 0); x <= cellCoord(p.x + r, 0); ++x) {
+                    fn(cellIndex(x, y, z));
+                }
+            }
+        }
+    };
+    for(const Obstacle& obstacle : obstacles) {
+        forEachCell(obstacle, [this](size_t cell) { ++cellStart[cell + 1]; });
+    }
+    for(size_t i = 1; i < cellStart.size(); ++i) {
+        cellStart[i] += cellStart[i - 1];
+    }
+
+    items.resize(cellStart.back());
+    std::vector<uint32_t> cursor(cellStart.begin(), cellStart.end() - 1);
+    for(size_t i = 0; i < obstacles.size(); ++i) {
+        forEachCell(obstacles[i], [&](size_t cell) { items[cursor[cell]++] = static_cast<uint32_t>(i); });
+    }
+}
+
+MemoryUsage ObstacleGrid::memoryUsage() const
+{
+    MemoryUsage usage = vectorMemory(cellStart);
+    usage += vectorMemory(items);
+    return usage;
+}
@@ -0,0 +1,231 @@
+#include "obstaclerenderer.h"
+#include "renderstats.h"
+#include "tracerecorder.h"
+#include <GL/glew.h>
+#include <QDebug>
+#include <QFile>
+#include <QDir>
+#include <QCoreApplication>
+
+// 初始化静态成员
+std::vector<glm::vec3> ObstacleRenderer::sphereVertices;
+std::vector<glm::vec3> ObstacleRenderer::sphereNormals;
+std::vector<std::vector<int>> ObstacleRenderer::sphereFaces;
+bool ObstacleRenderer::modelLoaded = false;
+
+bool ObstacleRenderer::loadSphereModel() {
+    if (modelLoaded) return true;
+    
+    // 获取可执行文件所在目录
+    QString exePath = QCoreApplication::applicationDirPath();
+    // 从 build 目录回到项目根目录
+    QDir projectDir = QDir(exePath);
+    projectDir.cdUp();  // 从 debug 目录出来
+    projectDir.cdUp();  // 从 build 目录出来
+    projectDir.cdUp();  // 从 out 目录出来
+    
+    // 构建模型文件的完整路径
+    QString filePath = projectDir.absoluteFilePath("objs/spiky_sphere/spiky_sphere_tiny.obj");
+    qDebug() << "当前目录：" << QDir::currentPath();
+    qDebug() << "项目目录：" << projectDir.absolutePath();
+    return loadSphereModel(filePath);
+}
+
+bool ObstacleRenderer::loadSphereModel(const QString& filePath) {
+    AQ_TRACE_SCOPE("asset", "ObstacleRenderer::loadSphereModel");
+    modelLoaded = false;
+    sphereVertices.clear();
+    sphereNormals.clear();
+    sphereFaces.clear();
+    
+    QFile file(filePath);
+    qDebug() << "尝试加载模型文件：" << filePath;
+    qDebug() << "文件是否存在：" << file.exists();
+    
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qDebug() << "无法打开模型文件：" << filePath;
+        qDebug() << "错误信息：" << file.errorString();
+        return false;
+    }
+    
+    int vertexCount = 0;
+    int faceCount = 0;
+    
+    while (!file.atEnd()) {
+        QString line = file.readLine().trimmed();
+        QStringList parts = line.split(' ', Qt::SkipEmptyParts);
+        
+        if (parts.isEmpty()) continue;
+        
+        if (parts[0] == "v" && parts.size() >= 4) {
+            float x = parts[1].toFloat();
+            float y = parts[2].toFloat();
+            float z = parts[3].toFloat();
+            sphereVertices.push_back(glm::vec3(x, y, z));
+            vertexCount++;
+        }
+        else if (parts[0] == "f" && parts.size() >= 4) {
+            std::vector<int> face;
+            for (int i = 1; i < parts.size(); ++i) {
+                QString indexStr = parts[i];
+                int slashPos = indexStr.indexOf('/');
+                if (slashPos != -1) {
+                    indexStr = indexStr.left(slashPos);
+                }
+                face.push_back(indexStr.toInt() - 1);
+            }
+            sphereFaces.push_back(face);
+            faceCount++;
+        }
+    }
+    
+    file.close();
+    
+    if (vertexCount == 0 || faceCount == 0) {
+        qDebug() << "模型加载失败：没有读取到有效的顶点或面数据";
+        return false;
+    }
+    
+    // 计算法线
+    sphereNormals.resize(sphereVertices.size(), glm::vec3(0.0f));
+    for (const auto& face : sphereFaces) {
+        if (face.size() < 3) continue;
+        glm::vec3 v1 = sphereVertices[face[1]] - sphereVertices[face[0]];
+        glm::vec3 v2 = sphereVertices[face[2]] - sphereVertices[face[0]];
+        glm::vec3 normal = glm::normalize(glm::cross(v1, v2));
+        
+        for (int idx : face) {
+            sphereNormals[idx] += normal;
+        }
+    }
+    
+    // 标准化法线
+    for (auto& normal : sphereNormals) {
+        normal = glm::normalize(normal);
+    }
+    
+    modelLoaded = true;
+    qDebug() << "模型加载成功："
+             << "\n顶点数量：" << vertexCount
+             << "\n面片数量：" << faceCount
+             << "\n当前工作目录：" << QDir::currentPath();
+    return true;
+}
+
+void ObstacleRenderer::draw(const Obstacle& obstacle)
+{
+    glPushMatrix();
+    const glm::vec3 position = obstacle.getPosition();
+    const float size = obstacle.getRadius();
+    glTranslatef(position.x, position.y, position.z);
+    
+    // 模型未加载时尖刺球退化为立方体绘制
+    if (obstacle.getType() == Obstacle::Type::SPIKY_SPHERE && modelLoaded) {
+        // 设置铁质材质属性
+        GLfloat metalColor[] = { 0.7f, 0.7f, 0.7f, 1.0f };  // 灰色基础色
+        GLfloat metalSpecular[] = { 1.0f, 1.0f, 1.0f, 1.0f };  // 高光颜色
+        GLfloat metalAmbient[] = { 0.2f, 0.2f, 0.2f, 1.0f };  // 环境光
+        GLfloat metalEmission[] = { 0.0f, 0.0f, 0.0f, 1.0f }; // 自发光
+        
+        glMaterialfv(GL_FRONT, GL_AMBIENT, metalAmbient);
+        glMaterialfv(GL_FRONT, GL_DIFFUSE, metalColor);
+        glMaterialfv(GL_FRONT, GL_SPECULAR, metalSpecular);
+        glMaterialf(GL_FRONT, GL_SHININESS, 128.0f);  // 高光度
+        glMaterialfv(GL_FRONT, GL_EMISSION, metalEmission);
+        
+        drawSpikySphere(size);
+    } else {
+        glColor4f(0.8f, 0.4f, 0.0f, 1.0f);  // 橙色
+        drawCube(size);
+        // 绘制轮廓
+        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+        glColor4f(0.0f, 0.0f, 0.0f, 1.0f);  // 黑色轮廓
+        glLineWidth(2.0f);
+        drawCube(size);
+        glLineWidth(1.0f);
+        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    }
+    
+    glPopMatrix();
+}
+
+void ObstacleRenderer::drawSpikySphere(float size) {
+    if (!modelLoaded) return;
+    
+    float scale = size;  // 直接使用size作为缩放因子，因为原模型半径为1
+    glPushMatrix();
+    glScalef(scale, scale, scale);
+    
+    glBegin(GL_TRIANGLES);
+    for (const auto& face : sphereFaces) {
+        for (int idx : face) {
+            glNormal3fv(&sphereNormals[idx][0]);
+            glVertex3fv(&sphereVertices[idx][0]);
+        }
+    }
+    glEnd();
+    RenderStats::countDraw();
+    
+    glPopMatrix();
+}
+
+void ObstacleRenderer::drawCube(float size)
+{
+    float s = size/2;
+    glBegin(GL_QUADS);
+    // 前面
+    glNormal3f(0.0f, 0.0f, 1.0f);
+    glVertex3f(-s, -s, s);
+    glVertex3f(s, -s, s);
+    glVertex3f(s, s, s);
+    glVertex3f(-s, s, s);
+    
+    // 后面
+    glNormal3f(0.0f, 0.0f, -1.0f);
+    glVertex3f(-s, -s, -s);
+    glVertex3f(-s, s, -s);
+    glVertex3f(s, s, -s);
+    glVertex3f(s, -s, -s);
+    
+    // 上面
+    glNormal3f(0.0f, 1.0f, 0.0f);
+    glVertex3f(-s, s, -s);
+    glVertex3f(-s, s, s);
+    glVertex3f(s, s, s);
+    glVertex3f(s, s, -s);
+    
+    // 下面
+    glNormal3f(0.0f, -1.0f, 0.0f);
+    glVertex3f(-s, -s, -s);
+    glVertex3f(s, -s, -s);
+    glVertex3f(s, -s, s);
+    glVertex3f(-s, -s, s);
+    
+    // 右面
+    glNormal3f(1.0f, 0.0f, 0.0f);
+    glVertex3f(s, -s, -s);
+    glVertex3f(s, s, -s);
+    glVertex3f(s, s, s);
+    glVertex3f(s, -s, s);
+    
+    // 左面
+    glNormal3f(-1.0f, 0.0f, 0.0f);
+    glVertex3f(-s, -s, -s);
+    glVertex3f(-s, -s, s);
+    glVertex3f(-s, s, s);
+    glVertex3f(-s, s, -s);
+    
+    glEnd();
+    RenderStats::countDraw();
+}
+
+void ObstacleRenderer::reportMemory(MemoryReport& report)
+{
+    report.add("obstacle_model.vertices", vectorMemory(sphereVertices));
+    report.add("obstacle_model.normals", vectorMemory(sphereNormals));
+    MemoryUsage faces = vectorMemory(sphereFaces);
+    for(const std::vector<int>& face : sphereFaces) {
+        faces += vectorMemory(face);
+    }
+    report.add("obstacle_model.faces", faces);
+}
@@ -0,0 +1,228 @@
+#include "poissondisksampler.h"
+#include <glm/gtc/constants.hpp>
+#include <algorithm>
+#include <cmath>
+
+PoissonDiskSampler::PoissonDiskSampler()
+    : boundsMin(0.0f)
+    , boundsMax(0.0f)
+    , minDistance(0.0f)
+    , cellSize(1.0f)
+    , invCellSize(1.0f)
+    , dims{0, 0, 0}
+    , searchRadius(0)
+{
+}
+
+void PoissonDiskSampler::reset(const glm::vec3& min, const glm::vec3& max, float distance)
+{
+    boundsMin = min;
+    boundsMax = glm::max(max, min);
+    minDistance = distance > 0.0f ? distance : 1.0f;
+
+    // 单元对角线等于最小间距时每个单元至多一个点；区域过大时放大单元，单元内用链表存放多个点
+    const glm::vec3 extent = glm::max(boundsMax - boundsMin, glm::vec3(1.0f));
+    cellSize = std::max(minDistance / std::sqrt(3.0f), std::cbrt(extent.x * extent.y * extent.z / MAX_CELLS));
+    for(;;) {
+        for(int axis = 0; axis < 3; ++axis) {
+            dims[axis] = std::max(1, static_cast<int>(std::ceil(extent[axis] / cellSize)));
+        }
+        if(static_cast<size_t>(dims[0]) * dims[1] * dims[2] <= MAX_CELLS) break;
+        cellSize *= 1.25f;
+    }
+    invCellSize = 1.0f / cellSize;
+    searchRadius = static_cast<int>(std::ceil(minDistance * invCellSize));
+
+    cellHead.assign(static_cast<size_t>(dims[0]) * dims[1] * dims[2], -1);
+    samples.clear();
+    active.clear();
+}
+
+void PoissonDiskSampler::clear()
+{
+    std::fill(cellHead.begin(), cellHead.end(), -1);
+    samples.clear();
+    active.clear();
+}
+
+int PoissonDiskSampler::cellCoord(float v, int axis) const
+{
+    int c = static_cast<int>(std::floor((v - boundsMin[axis]) * invCellSize));
+    return std::min(std::max(c, 0), dims[axis] - 1);
+}
+
+size_t PoissonDiskSampler::cellOf(const glm::vec3& point) const
+{
+    return (static_cast<size_t>(cellCoord(point.z, 2)) * dims[1] + cellCoord(point.y, 1)) * dims[0] +
+           cellCoord(point.x, 0);
+}
+
+bool PoissonDiskSampler::contains(const glm::vec3& point) const
+{
+    return point.x >= boundsMin.x && point.x <= boundsMax.x &&
+           point.y >= boundsMin.y && point.y <= boundsMax.y &&
+           point.z >= boundsMin.z && point.z <= boundsMax.z;
+}
+
+bool PoissonDiskSampler::isFarEnough(const glm::vec3& point) const
+{
+    if(cellHead.empty()) return false;
+
+    const float minDistance2 = minDistance * minDistance;
+    const int cx = cellCoord(point.x, 0), cy = cellCoord(point.y, 1), cz = cellCoord(point.z, 2);
+    for(int z = std::max(cz - searchRadius, 0); z <= std::min(cz + searchRadius, dims[2] - 1); ++z) {
+        for(int y = std::max(cy - searchRadius, 0); y <= std::min(cy + searchRadius, dims[1] - 1); ++y) {
+            for(int x = std::max(cx - searchRadius, 0); x <= std::min(cx + searchRadius, dims[0] - 1); ++x) {
+                size_t cell = (static_cast<size_t>(z) * dims[1] + y) * dims[0] + x;
+                for(int i = cellHead[cell]; i >= 0; i = samples[i].next) {
+                    glm::vec3 d = samples[i].position - point;
+                    if(glm::dot(d, d) < minDistance2) return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool PoissonDiskSampler::insert(const glm::vec3& point)
+{
+    if(!isFarEnough(point)) return false;
+
+    Sample sample;
+    sample.position = point;
+    sample.next = -1;
+    sample.activeSlot = -1;
+    samples.push_back(sample);
+    int index = static_cast<int>(samples.size()) - 1;
+    link(index);
+    activate(index);
+    return true;
+}
+
+void PoissonDiskSampler::remove(const glm::vec3& point)
+{
+    int index = findSample(point);
+    if(index >= 0) removeAt(static_cast<size_t>(index));
+}
+
+void PoissonDiskSampler::removeAt(size_t sampleIndex)
+{
+    if(sampleIndex >= samples.size()) return;
+    const int index = static_cast<int>(sampleIndex);
+    const glm::vec3 point = samples[index].position;
+
+    deactivate(index);
+    unlink(index);
+
+    // 末尾的点移到空出的位置，同时更新单元链表和活动列表中对它的引用
+    int last = static_cast<int>(samples.size()) - 1;
+    if(index != last) {
+        unlink(last);
+        samples[index] = samples[last];
+        if(samples[index].activeSlot >= 0) {
+            active[samples[index].activeSlot].sample = static_cast<uint32_t>(index);
+        }
+        link(index);
+    }
+    samples.pop_back();
+
+    // 空出的位置只可能被距其 2r 以内的点周围的球壳覆盖，重新激活这些点
+    const float reach = 2.0f * minDistance;
+    const int layers = static_cast<int>(std::ceil(reach * invCellSize));
+    const int cx = cellCoord(point.x, 0), cy = cellCoord(point.y, 1), cz = cellCoord(point.z, 2);
+    for(int z = std::max(cz - layers, 0); z <= std::min(cz + layers, dims[2] - 1); ++z) {
+        for(int y = std::max(cy - layers, 0); y <= std::min(cy + layers, dims[1] - 1); ++y) {
+            for(int x = std::max(cx - layers, 0); x <= std::min(cx + layers, dims[0] - 1); ++x) {
+                size_t cell = (static_cast<size_t>(z) * dims[1] + y) * dims[0] + x;
+                for(int i = cellHead[cell]; i >= 0; i = samples[i].next) {
+                    if(glm::distance(samples[i].position, point) < reach) activate(i);
+                }
+            }
+        }
+    }
+}
+
+int PoissonDiskSampler::findSample(const glm::vec3& point) const
+{
+    if(cellHead.empty()) return -1;
+    for(int i = cellHead[cellOf(point)]; i >= 0; i = samples[i].next) {
+        if(samples[i].position == point) return i;
+    }
+    return -1;
+}
+
+void PoissonDiskSampler::link(int index)
+{
+    size_t cell = cellOf(samples[index].position);
+    samples[index].next = cellHead[cell];
+    cellHead[cell] = index;
+}
+
+void PoissonDiskSampler::unlink(int index)
+{
+    int32_t* link = &cellHead[cellOf(samples[index].position)];
+    while(*link >= 0 && *link != index) {
+        link = &samples[*link].next;
+    }
+    if(*link == index) *link = samples[index].next;
+}
+
+void PoissonDiskSampler::activate(int index)
+{
+    if(samples[index].activeSlot >= 0) {
+        active[samples[index].activeSlot].failures = 0;
+        return;
+    }
+    ActivePoint point;
+    point.sample = static_cast<uint32_t>(index);
+    point.failures = 0;
+    samples[index].activeSlot = static_cast<int32_t>(active.size());
+    active.push_back(point);
+}
+
+void PoissonDiskSampler::deactivate(int index)
+{
+    int slot = samples[index].activeSlot;
+    if(slot < 0) return;
+    samples[index].activeSlot = -1;
+    active[slot] = active.back();
+    active.pop_back();
+    if(slot < static_cast<int>(active.size())) {
+        samples[active[slot].sample].activeSlot = slot;
+    }
+}
+
+glm::vec3 PoissonDiskSampler::candidate(Rng& rng, int attempt, int& activeSlot)
+{
+    if(attempt < UNIFORM_ATTEMPTS || active.empty()) {
+        activeSlot = -1;
+        return glm::vec3(rng.uniform(boundsMin.x, boundsMax.x),
+                         rng.uniform(boundsMin.y, boundsMax.y),
+                         rng.uniform(boundsMin.z, boundsMax.z));
+    }
+
+    // 在活动点周围 [r, 2r] 的球壳内取点，方向在球面上均匀分布
+    activeSlot = static_cast<int>(rng.below(static_cast<uint32_t>(active.size())));
+    const glm::vec3 center = samples[active[activeSlot].sample].position;
+    float cosTheta = rng.signedUnit();
+    float sinTheta = std::sqrt(std::max(0.0f, 1.0f - cosTheta * cosTheta));
+    float phi = rng.nextFloat() * glm::two_pi<float>();
+    float radius = minDistance * (1.0f + rng.nextFloat());
+    return center + radius * glm::vec3(sinTheta * std::cos(phi), cosTheta, sinTheta * std::sin(phi));
+}
+
+void PoissonDiskSampler::reject(int activeSlot)
+{
+    if(activeSlot < 0 || activeSlot >= static_cast<int>(active.size())) return;
+    if(++active[activeSlot].failures >= ANNULUS_ATTEMPTS) {
+        deactivate(static_cast<int>(active[activeSlot].sample));
+    }
+}
+
+MemoryUsage PoissonDiskSampler::memoryUsage() const
+{
+    MemoryUsage usage = vectorMemory(cellHead);
+    usage += vectorMemory(samples);
+    usage += vectorMemory(active);
+    return usage;
+}
@@ -0,0 +1,231 @@
+#include "renderbenchmark.h"
+#include "gamewidget.h"
+#include "renderstats.h"
+#include "logging.h"
+#include <QOpenGLContext>
+#include <QOffscreenSurface>
+#include <QOpenGLFramebufferObject>
+#include <QSurfaceFormat>
+#include <glm/gtc/constants.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+
+RenderBenchmark::RenderBenchmark(const Options& options)
+    : options(options)
+    , vertexQueries(false)
+{
+}
+
+const char* RenderBenchmark::segmentName(Segment segment)
+{
+    switch(segment) {
+        case ABOVE_WATER: return "above-water";
+        case UNDERWATER: return "underwater";
+        case TOP_DOWN: return "top-down";
+        default: return "unknown";
+    }
+}
+
+// 帧数平均分为三段，余数归最后一段
+RenderBenchmark::Segment RenderBenchmark::segmentOf(int frame) const
+{
+    int length = std::max(1, options.frames / SEGMENT_COUNT);
+    return static_cast<Segment>(std::min(frame / length, SEGMENT_COUNT - 1));
+}
+
+void RenderBenchmark::setupCamera(GameWidget& widget, int frame) const
+{
+    Segment segment = segmentOf(frame);
+    int length = std::max(1, options.frames / SEGMENT_COUNT);
+    int first = segment * length;
+    int count = segment == SEGMENT_COUNT - 1 ? options.frames - first : length;
+    float t = count > 1 ? float(frame - first) / float(count - 1) : 0.0f;
+
+    const float size = widget.aquariumSize;
+    const float waterHeight = widget.water->getWaterHeight();
+    glm::vec3 up(0.0f, 1.0f, 0.0f);
+
+    switch(segment) {
+        case ABOVE_WATER: {
+            // 在水面上方绕水族箱一周，始终看向中心
+            float angle = t * glm::two_pi<float>();
+            float radius = size * 0.8f;
+            widget.cameraPos = glm::vec3(radius * std::sin(angle), waterHeight + size * 0.25f, radius * std::cos(angle));
+            widget.cameraTarget = glm::vec3(0.0f);
+            widget.currentCameraMode = GameWidget::CameraMode::FOLLOW;
+            break;
+        }
+        case UNDERWATER: {
+            // 在水面以下沿对角线穿过水族箱
+            glm::vec3 start(-size * 0.4f, waterHeight * 0.3f, size * 0.3f);
+            glm::vec3 end(size * 0.4f, -waterHeight * 0.3f, -size * 0.3f);
+            widget.cameraPos = glm::mix(start, end, t);
+            widget.cameraTarget = widget.cameraPos + glm::normalize(end - start) * 500.0f;
+            widget.currentCameraMode = GameWidget::CameraMode::FOLLOW;
+            break;
+        }
+        default: {
+            // 与游戏中的俯视视角相同的高度和上方向，沿 x 轴平移经过蛇头
+            glm::vec3 head = widget.snake->getHeadPosition();
+            glm::vec3 pan(size * 0.4f * (t - 0.5f), 0.0f, 0.0f);
+            widget.cameraTarget = head + pan;
+            widget.cameraPos = widget.cameraTarget + glm::vec3(0.0f, GameWidget::TOP_DOWN_HEIGHT, 0.0f);
+            widget.currentCameraMode = GameWidget::CameraMode::TOP_DOWN;
+            up = glm::vec3(0.0f, 0.0f, -1.0f);
+            break;
+        }
+    }
+
+    widget.previousCameraPos = widget.cameraPos;
+    widget.previousCameraTarget = widget.cameraTarget;
+    widget.viewMatrix = glm::lookAt(widget.cameraPos, widget.cameraTarget, up);
+    widget.renderCameraPos = widget.cameraPos;
+    widget.snake->setProjectionMatrix(widget.projectionMatrix);
+    widget.snake->setViewMatrix(widget.viewMatrix);
+    widget.water->setCameraPosition(widget.cameraPos);
+}
+
+int RenderBenchmark::run()
+{
+    if(options.frames <= 0 || options.width <= 0 || options.height <= 0) {
+        std::fprintf(stderr, "render benchmark: invalid frame count or size\n");
+        return 1;
+    }
+
+    // 固定管线绘制需要兼容模式上下文
+    QSurfaceFormat format;
+    format.setVersion(3, 3);
+    format.setProfile(QSurfaceFormat::CompatibilityProfile);
+    format.setDepthBufferSize(24);
+    format.setStencilBufferSize(8);
+
+    QOpenGLContext context;
+    context.setFormat(format);
+    if(!context.create()) {
+        std::fprintf(stderr, "render benchmark: failed to create OpenGL context\n");
+        return 1;
+    }
+    QOffscreenSurface surface;
+    surface.setFormat(context.format());
+    surface.create();
+    if(!surface.isValid() || !context.makeCurrent(&surface)) {
+        std::fprintf(stderr, "render benchmark: failed to make offscreen surface current\n");
+        return 1;
+    }
+
+    // GameWidget 不显示，也不创建自己的上下文；初始化和绘制都在这里的上下文中进行
+    std::unique_ptr<GameWidget> widget(new GameWidget());
+    widget->gameTimer->stop();
+    widget->resize(options.width, options.height);
+    widget->initializeGL();
+    widget->resetSimulation(BENCHMARK_SEED);
+
+    QOpenGLFramebufferObjectFormat fboFormat;
+    fboFormat.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
+    std::unique_ptr<QOpenGLFramebufferObject> fbo(
+        new QOpenGLFramebufferObject(options.width, options.height, fboFormat));
+    if(!fbo->isValid() || !fbo->bind()) {
+        std::fprintf(stderr, "render benchmark: failed to create framebuffer object\n");
+        widget.reset();
+        context.doneCurrent();
+        return 1;
+    }
+    widget->resizeGL(options.width, options.height);
+
+    // 提交的顶点数用管线统计查询获取，包含立即模式提交的顶点
+    GLuint vertexQuery = 0;
+    vertexQueries = GLEW_ARB_pipeline_statistics_query;
+    if(vertexQueries) {
+        glGenQueries(1, &vertexQuery);
+    }
+
+    std::printf("render benchmark: %d frames at %dx%d on %s\n", options.frames, options.width, options.height,
+                reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+    std::printf("scale: %s\n", GameWidget::getSimulationConfig().summary().c_str());
+
+    samples.clear();
+    samples.reserve(options.frames);
+    glm::vec3 particleTarget = widget->snake->getHeadPosition();
+    for(int frame = 0; frame < options.frames; ++frame) {
+        setupCamera(*widget, frame);
+        widget->water->update(FRAME_DELTA);
+        widget->water->updateWaterParticles(FRAME_DELTA, particleTarget);
+
+        RenderStats::reset();
+        if(vertexQueries) glBeginQuery(GL_VERTICES_SUBMITTED_ARB, vertexQuery);
+        auto start = std::chrono::steady_clock::now();
+        widget->paintGL();
+        glFinish();
+        auto end = std::chrono::steady_clock::now();
+        if(vertexQueries) glEndQuery(GL_VERTICES_SUBMITTED_ARB);
+
+        FrameSample sample;
+        sample.segment = segmentOf(frame);
+        sample.frameTime = std::chrono::duration<float, std::milli>(end - start).count();
+        sample.drawCalls = RenderStats::drawCalls;
+        sample.vertices = 0;
+        if(vertexQueries) {
+            GLuint64 vertices = 0;
+            glGetQueryObjectui64v(vertexQuery, GL_QUERY_RESULT, &vertices);
+            sample.vertices = vertices;
+        }
+        samples.push_back(sample);
+    }
+
+    if(vertexQueries) glDeleteQueries(1, &vertexQuery);
+    fbo->release();
+    fbo.reset();
+    widget.reset();  // 析构时释放GL资源，需要上下文仍为当前
+    context.doneCurrent();
+
+    printReport();
+    return 0;
+}
+
+void RenderBenchmark::printPercentiles(const char* label, std::vector<float> times)
+{
+    if(times.empty()) return;
+    std::sort(times.begin(), times.end());
+    auto at = [&times](double p) {
+        size_t rank = static_cast<size_t>(std::ceil(times.size() * p));
+        return times[std::min(times.size(), std::max<size_t>(rank, 1)) - 1];
+    };
+    std::printf("  %-12s %5zu frames  p50 %7.2f  p90 %7.2f  p99 %7.2f  max %7.2f ms\n",
+                label, times.size(), at(0.50), at(0.90), at(0.99), times.back());
+}
+
+void RenderBenchmark::printReport() const
+{
+    std::vector<float> all;
+    std::vector<float> bySegment[SEGMENT_COUNT];
+    uint64_t drawCalls[SEGMENT_COUNT] = {};
+    uint64_t vertices[SEGMENT_COUNT] = {};
+    for(const FrameSample& sample : samples) {
+        all.push_back(sample.frameTime);
+        bySegment[sample.segment].push_back(sample.frameTime);
+        drawCalls[sample.segment] += sample.drawCalls;
+        vertices[sample.segment] += sample.vertices;
+    }
+
+    std::printf("frame time (paintGL + glFinish):\n");
+    printPercentiles("all", all);
+    for(int i = 0; i < SEGMENT_COUNT; ++i) {
+        printPercentiles(segmentName(static_cast<Segment>(i)), bySegment[i]);
+    }
+
+    std::printf("per frame averages:\n");
+    for(int i = 0; i < SEGMENT_COUNT; ++i) {
+        size_t count = bySegment[i].size();
+        if(count == 0) continue;
+        std::printf("  %-12s draw calls %8.1f  vertices ", segmentName(static_cast<Segment>(i)),
+                    double(drawCalls[i]) / count);
+        if(vertexQueries) {
+            std::printf("%12.0f\n", double(vertices[i]) / count);
+        } else {
+            std::printf("%12s\n", "n/a");
+        }
+    }
+}
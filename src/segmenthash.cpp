@@ -0,0 +1,52 @@
+#include "segmenthash.h"
+
+SegmentHash::SegmentHash(float cellSize)
+    : cellSize(cellSize)
+    , invCellSize(1.0f / cellSize)
+{
+}
+
+void SegmentHash::clear()
+{
+    cells.clear();
+}
+
+void SegmentHash::insert(uint64_t sequence, const glm::vec3& position)
+{
+    Entry entry;
+    entry.position = position;
+    entry.sequence = sequence;
+    cells[keyOf(position)].push_back(entry);
+}
+
+void SegmentHash::remove(uint64_t sequence, const glm::vec3& position)
+{
+    auto it = cells.find(keyOf(position));
+    if(it == cells.end()) return;
+
+    Cell& cell = it->second;
+    for(size_t i = 0; i < cell.size(); ++i) {
+        if(cell[i].sequence == sequence) {
+            // 与末尾交换后弹出，单元内顺序无关紧要
+            cell[i] = cell.back();
+            cell.pop_back();
+            break;
+        }
+    }
+
+    if(cell.empty()) {
+        cells.erase(it);
+    }
+}
+
+MemoryUsage SegmentHash::memoryUsage() const
+{
+    // 哈希表的节点与桶数组按 libstdc++ 的布局估算：每个节点一个 next 指针加键值对
+    const size_t nodeBytes = sizeof(void*) + sizeof(std::pair<const uint64_t, Cell>);
+    MemoryUsage usage;
+    usage.size = usage.capacity = cells.size() * nodeBytes + cells.bucket_count() * sizeof(void*);
+    for(const auto& cell : cells) {
+        usage += vectorMemory(cell.second);
+    }
+    return usage;
+}
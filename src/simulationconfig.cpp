@@ -0,0 +1,170 @@
+#include "simulationconfig.h"
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace {
+    struct Preset {
+        const char* name;
+        int obstacleCount;      // -1 表示沿用默认值
+        int foodCount;
+        int waterParticleCount;
+        int snakeLength;
+    };
+
+    // 单项预设只放大一个子系统，stress 同时放大全部
+    const Preset PRESETS[] = {
+        { "default",            -1,     -1,      -1,      -1 },
+        { "obstacles-10k",   10000,     -1,      -1,      -1 },
+        { "food-50k",           -1,  50000,      -1,      -1 },
+        { "particles-100k",     -1,     -1,  100000,      -1 },
+        { "snake-100k",         -1,     -1,      -1,  100000 },
+        { "stress",          10000,  50000,  100000,  100000 },
+    };
+
+    std::string trim(const std::string& text)
+    {
+        const char* spaces = " \t\r\n";
+        size_t begin = text.find_first_not_of(spaces);
+        if(begin == std::string::npos) return std::string();
+        size_t end = text.find_last_not_of(spaces);
+        return text.substr(begin, end - begin + 1);
+    }
+
+    bool parseInt(const std::string& text, int minimum, int& value)
+    {
+        errno = 0;
+        char* end = nullptr;
+        long parsed = std::strtol(text.c_str(), &end, 10);
+        if(text.empty() || *end != '\0' || errno == ERANGE) return false;
+        if(parsed < minimum || parsed > 100000000L) return false;
+        value = static_cast<int>(parsed);
+        return true;
+    }
+
+    bool parseFloat(const std::string& text, float& value)
+    {
+        char* end = nullptr;
+        float parsed = std::strtof(text.c_str(), &end);
+        if(text.empty() || *end != '\0' || !std::isfinite(parsed) || parsed <= 0.0f) return false;
+        value = parsed;
+        return true;
+    }
+}
+
+bool SimulationConfig::applyPreset(const std::string& name, std::string& error)
+{
+    for(const Preset& preset : PRESETS) {
+        if(name != preset.name) continue;
+        *this = SimulationConfig();
+        if(preset.obstacleCount >= 0) obstacleCount = preset.obstacleCount;
+        if(preset.foodCount >= 0) foodCount = preset.foodCount;
+        if(preset.waterParticleCount >= 0) waterParticleCount = preset.waterParticleCount;
+        if(preset.snakeLength >= 0) snakeLength = preset.snakeLength;
+        return true;
+    }
+    error = "unknown preset '" + name + "'";
+    return false;
+}
+
+bool SimulationConfig::set(const std::string& key, const std::string& rawValue, std::string& error)
+{
+    const std::string value = trim(rawValue);
+    bool ok;
+    if(key == "preset") {
+        return applyPreset(value, error);
+    } else if(key == "aquarium_size") {
+        ok = parseFloat(value, aquariumSize);
+    } else if(key == "obstacles") {
+        ok = parseInt(value, 0, obstacleCount);
+    } else if(key == "food") {
+        ok = parseInt(value, 0, foodCount);
+    } else if(key == "water_particles") {
+        ok = parseInt(value, 0, waterParticleCount);
+    } else if(key == "snake_length") {
+        ok = parseInt(value, 1, snakeLength);
+    } else {
+        error = "unknown key '" + key + "'";
+        return false;
+    }
+    if(!ok) error = "invalid value '" + value + "' for " + key;
+    return ok;
+}
+
+bool SimulationConfig::loadFile(const std::string& path, std::string& error)
+{
+    std::ifstream in(path);
+    if(!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    std::string line;
+    int lineNumber = 0;
+    while(std::getline(in, line)) {
+        ++lineNumber;
+        line = trim(line);
+        if(line.empty() || line[0] == '#') continue;
+
+        size_t equals = line.find('=');
+        if(equals == std::string::npos) {
+            error = path + ":" + std::to_string(lineNumber) + ": expected key=value";
+            return false;
+        }
+        std::string lineError;
+        if(!set(trim(line.substr(0, equals)), line.substr(equals + 1), lineError)) {
+            error = path + ":" + std::to_string(lineNumber) + ": " + lineError;
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string SimulationConfig::summary() const
+{
+    std::ostringstream out;
+    out << "aquarium_size=" << aquariumSize
+        << " obstacles=" << obstacleCount
+        << " food=" << foodCount
+        << " water_particles=" << waterParticleCount
+        << " snake_length=" << snakeLength;
+    return out.str();
+}
+
+SimulationScale SimulationConfig::scale() const
+{
+    SimulationScale result;
+    result.aquariumSize = aquariumSize;
+    result.obstacleCount = static_cast<uint32_t>(obstacleCount);
+    result.foodCount = static_cast<uint32_t>(foodCount);
+    result.snakeLength = static_cast<uint32_t>(snakeLength);
+    return result;
+}
+
+void SimulationConfig::applyScale(const SimulationScale& scale)
+{
+    aquariumSize = scale.aquariumSize;
+    obstacleCount = static_cast<int>(scale.obstacleCount);
+    foodCount = static_cast<int>(scale.foodCount);
+    snakeLength = static_cast<int>(scale.snakeLength);
+}
+
+const std::vector<std::string>& SimulationConfig::presetNames()
+{
+    static const std::vector<std::string> names = [] {
+        std::vector<std::string> result;
+        for(const Preset& preset : PRESETS) result.push_back(preset.name);
+        return result;
+    }();
+    return names;
+}
+
+const std::vector<std::string>& SimulationConfig::keys()
+{
+    static const std::vector<std::string> names = {
+        "aquarium_size", "obstacles", "food", "water_particles", "snake_length"
+    };
+    return names;
+}
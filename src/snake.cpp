@@ -1,31 +1,170 @@
 #define GLM_ENABLE_EXPERIMENTAL
 #include <GL/glew.h>
 #include <QOpenGLFunctions>
+#include <QOpenGLContext>
 #include "snake.h"
+#include "spheremesh.h"
+#include "renderstats.h"
+#include "tracerecorder.h"
+#include "logging.h"
 #include <cmath>
+#include <algorithm>
+#include <cstddef>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
-Snake::Snake(float x, float y, float z)
-    : segmentSize(DEFAULT_SEGMENT_SIZE)
-    , moveSpeed(DEFAULT_MOVE_SPEED)
-    , direction(1.0f, 0.0f, 0.0f)
-    , targetDirection(direction)
-    , upDirection(0.0f, 1.0f, 0.0f)
+// 蛇身实例化渲染的顶点着色器
+// 使用兼容模式以沿用固定管线的矩阵、光源、材质和雾效设置
+const char* Snake::segmentVertexShader = R"(
+    #version 330 compatibility
+    layout (location = 0) in vec3 aPos;         // 单位球顶点，同时也是法线
+    layout (location = 1) in vec4 aInstance;    // xyz: 段中心, w: 半径
+    layout (location = 2) in float aGradient;   // 渐变参数t，0为底部颜色，1为顶部颜色
+    
+    uniform vec3 gradientTop;
+    uniform vec3 gradientBottom;
+    
+    out vec3 vNormal;
+    out vec3 vEyePos;
+    out vec3 vColor;
+    
+    void main()
+    {
+        vec4 eyePos = gl_ModelViewMatrix * vec4(aInstance.xyz + aPos * aInstance.w, 1.0);
+        vEyePos = eyePos.xyz;
+        vNormal = mat3(gl_ModelViewMatrix) * aPos;
+        vColor = mix(gradientBottom, gradientTop, aGradient);
+        gl_Position = gl_ProjectionMatrix * eyePos;
+    }
+)";
+
+// 蛇身实例化渲染的片段着色器（逐像素计算已启用的固定管线光源）
+const char* Snake::segmentFragmentShader = R"(
+    #version 330 compatibility
+    in vec3 vNormal;
+    in vec3 vEyePos;
+    in vec3 vColor;
+    
+    uniform int lightMask;      // 已启用光源的位掩码
+    uniform bool fogEnabled;
+    
+    out vec4 FragColor;
+    
+    void main()
+    {
+        vec3 N = normalize(vNormal);
+        vec3 V = normalize(-vEyePos);
+        vec3 color = gl_LightModel.ambient.rgb * vColor;
+        
+        for(int i = 0; i < 8; ++i) {
+            if((lightMask & (1 << i)) == 0) continue;
+            
+            vec4 lightPos = gl_LightSource[i].position;
+            vec3 L;
+            float attenuation = 1.0;
+            if(lightPos.w == 0.0) {
+                L = normalize(lightPos.xyz);
+            } else {
+                vec3 toLight = lightPos.xyz - vEyePos;
+                float dist = length(toLight);
+                L = toLight / dist;
+                attenuation = 1.0 / (gl_LightSource[i].constantAttenuation +
+                                     gl_LightSource[i].linearAttenuation * dist +
+                                     gl_LightSource[i].quadraticAttenuation * dist * dist);
+            }
+            
+            float NdotL = max(dot(N, L), 0.0);
+            float spec = 0.0;
+            if(NdotL > 0.0) {
+                spec = pow(max(dot(N, normalize(L + V)), 0.0), gl_FrontMaterial.shininess);
+            }
+            
+            color += attenuation * (gl_LightSource[i].ambient.rgb * vColor +
+                                    gl_LightSource[i].diffuse.rgb * vColor * NdotL +
+                                    gl_LightSource[i].specular.rgb * gl_FrontMaterial.specular.rgb * spec);
+        }
+        
+        if(fogEnabled) {
+            float fogFactor = exp(-pow(gl_Fog.density * length(vEyePos), 2.0));
+            color = mix(gl_Fog.color.rgb, color, clamp(fogFactor, 0.0, 1.0));
+        }
+        
+        FragColor = vec4(color, 1.0);
+    }
+)";
+
+// 管状蛇身的顶点着色器，不使用顶点属性
+// 每个四边形6个顶点，按 gl_VertexID 计算所在的环和截面角度
+// 环按段序号取模存放，逻辑下标为ring的环位于 headSlot - ring 处
+const char* Snake::tubeVertexShader = R"(
+    #version 330 compatibility
+    uniform samplerBuffer ringData;   // 每个环3个texel：中心、法线、副法线
+    uniform int headSlot;             // 蛇头所在的环槽位
+    uniform int slotMask;             // 环的容量减一
+    uniform int ringCount;
+    uniform int sides;
+    uniform float radius;
+    uniform vec3 gradientTop;
+    uniform vec3 gradientBottom;
+    
+    out vec3 vNormal;
+    out vec3 vEyePos;
+    out vec3 vColor;
+    
+    const ivec2 corners[6] = ivec2[6](ivec2(0, 0), ivec2(0, 1), ivec2(1, 1),
+                                      ivec2(0, 0), ivec2(1, 1), ivec2(1, 0));
+    
+    void main()
+    {
+        int quad = gl_VertexID / 6;
+        ivec2 corner = corners[gl_VertexID % 6];
+        int ring = quad / sides + corner.x;
+        int side = quad % sides + corner.y;
+        int slot = (headSlot - ring + slotMask + 1) & slotMask;
+        
+        vec3 center = texelFetch(ringData, slot * 3).xyz;
+        vec3 N = texelFetch(ringData, slot * 3 + 1).xyz;
+        vec3 B = texelFetch(ringData, slot * 3 + 2).xyz;
+        
+        float angle = 6.28318530718 * float(side) / float(sides);
+        vec3 normal = cos(angle) * N + sin(angle) * B;
+        
+        // 与球体相同的渐变：蛇头为顶部颜色，蛇身从头到尾逐渐变暗
+        float gradient = ring == 0 ? 1.0 : 1.0 - float(ring) / float(ringCount) * 0.3;
+        
+        vec4 eyePos = gl_ModelViewMatrix * vec4(center + normal * radius, 1.0);
+        vEyePos = eyePos.xyz;
+        vNormal = mat3(gl_ModelViewMatrix) * normal;
+        vColor = mix(gradientBottom, gradientTop, gradient);
+        gl_Position = gl_ProjectionMatrix * eyePos;
+    }
+)";
+
+Snake::Snake(float x, float y, float z, int initialLength)
+    : SnakeCore(x, y, z, initialLength)
+    , renderAlpha(1.0f)
+    , finVBO(0)
+    , instancingInitialized(false)
+    , glContext(nullptr)
+    , segmentProgram(0)
+    , instanceVBO(0)
+    , tubeRendering(false)
+    , tubeProgram(0)
+    , tubeBuffer(0)
+    , tubeTexture(0)
+    , tubeMask(0)
+    , tubeCacheValid(false)
+    , tubeCachedThrough(0)
     , projectionMatrix(1.0f)
     , viewMatrix(1.0f)
     , frustumPlanesUpdated(false)
 {
-    // 设置初始位置
-    glm::vec3 initialPos(x, y, z);
-    
-    // 设置初始长度为3段
-    const int INITIAL_LENGTH = 3;
-    for(int i = 0; i < INITIAL_LENGTH; ++i) {
-        // 每一段都在前一段的后面，沿着-X方向排列
-        glm::vec3 segmentPos = initialPos - glm::vec3(i * segmentSize, 0.0f, 0.0f);
-        body.push_back(segmentPos);
-    }
+    storePreviousState();
+}
+
+Snake::~Snake()
+{
+    releaseInstancedRendering();
 }
 
 void Snake::initializeGL()
@@ -33,105 +172,168 @@ void Snake::initializeGL()
     initializeOpenGLFunctions();
 }
 
-void Snake::move()
+void Snake::initInstancedRendering()
 {
-    // 平滑转向，但速度更快
-    if (glm::length(targetDirection - direction) > 0.01f) {
-        direction = glm::normalize(
-            glm::mix(direction, targetDirection, TURN_SPEED)
-        );
-        updateDirections();
-    }
-
-    // 更新蛇的位置
-    glm::vec3 newHead = body.front() + direction * moveSpeed;
+    instancingInitialized = true;
+    glContext = QOpenGLContext::currentContext();
+    if(!glContext) return;
+    
+    initializeOpenGLFunctions();
+    
+    // 背鳍的动态顶点缓冲区不依赖实例化
+    glGenBuffers(1, &finVBO);
     
-    // 移动蛇身（每个段都跟随前一个段）
-    for(size_t i = body.size() - 1; i > 0; --i) {
-        body[i] = body[i-1];
+    // 实例化绘制需要 OpenGL 3.3
+    if(!glewIsSupported("GL_VERSION_3_3")) {
+        AQ_WARNING(lcGame) << "Instanced rendering not supported, falling back to immediate mode";
+        return;
     }
-    body[0] = newHead;
-
-    // 检查自身碰撞
-    if(checkSelfCollision()) {
-        // 通知游戏结束
-        // 这里需要添加一个回调机制
+    
+    segmentProgram = buildProgram(segmentVertexShader, segmentFragmentShader, "Snake segment");
+    if(!segmentProgram) return;
+    
+    // 管状模式与球体共用片段着色器，纹理缓冲区需要 OpenGL 3.1，已包含在3.3中
+    tubeProgram = buildProgram(tubeVertexShader, segmentFragmentShader, "Snake tube");
+    if(tubeProgram) {
+        glGenBuffers(1, &tubeBuffer);
+        glGenTextures(1, &tubeTexture);
     }
+    
+    // 单位球网格由 SphereMesh 统一缓存，这里只需创建实例缓冲区
+    glGenBuffers(1, &instanceVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
-void Snake::grow()
+GLuint Snake::buildProgram(const char* vertexSource, const char* fragmentSource, const char* name)
 {
-    // 在尾部添加新段，位置与最后一段相同
-    if(!body.empty()) {
-        body.push_back(body.back());
+    AQ_TRACE_SCOPE("shader", "Snake::buildProgram");
+    GLint success;
+    GLchar infoLog[512];
+    
+    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vertexShader, 1, &vertexSource, NULL);
+    glCompileShader(vertexShader);
+    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
+    if(!success) {
+        glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
+        AQ_WARNING(lcGame) << name << "vertex shader compilation failed:\n" << infoLog;
+        glDeleteShader(vertexShader);
+        return 0;
     }
-}
-
-void Snake::setDirection(const glm::vec3& newDir)
-{
-    if (glm::length(newDir) < 0.01f) return;
-
-    // 保存旧的方向用于平滑过渡
-    glm::vec3 oldDirection = direction;
     
-    // 规范化新方向
-    targetDirection = glm::normalize(newDir);
+    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(fragmentShader, 1, &fragmentSource, NULL);
+    glCompileShader(fragmentShader);
+    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
+    if(!success) {
+        glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
+        AQ_WARNING(lcGame) << name << "fragment shader compilation failed:\n" << infoLog;
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+        return 0;
+    }
     
-    // 使用glm::rotate函数代替四元数直接操作
-    float angle = glm::acos(glm::dot(glm::normalize(oldDirection), targetDirection));
-    if (angle > 0.01f) {  // 确保有足够的角度差异
-        glm::vec3 rotationAxis = glm::cross(oldDirection, targetDirection);
-        if (glm::length(rotationAxis) > 0.01f) {  // 确保旋转轴有效
-            upDirection = glm::rotate(upDirection, angle, glm::normalize(rotationAxis));
-        }
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vertexShader);
+    glAttachShader(program, fragmentShader);
+    glLinkProgram(program);
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+    
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if(!success) {
+        glGetProgramInfoLog(program, 512, NULL, infoLog);
+        AQ_WARNING(lcGame) << name << "shader program linking failed:\n" << infoLog;
+        glDeleteProgram(program);
+        return 0;
     }
+    return program;
 }
 
-void Snake::rotateAroundAxis(const glm::vec3& axis, float angle)
+void Snake::releaseInstancedRendering()
 {
-    // 使用glm::rotate函数进行旋转
-    glm::vec3 normalizedAxis = glm::normalize(axis);
-    direction = glm::rotate(direction, angle, normalizedAxis);
-    upDirection = glm::rotate(upDirection, angle, normalizedAxis);
-    targetDirection = direction;
+    // 只有在创建资源的上下文仍为当前上下文时才能安全删除
+    if(!glContext || QOpenGLContext::currentContext() != glContext) return;
+    
+    if(segmentProgram) glDeleteProgram(segmentProgram);
+    if(instanceVBO) glDeleteBuffers(1, &instanceVBO);
+    if(finVBO) glDeleteBuffers(1, &finVBO);
+    if(tubeProgram) glDeleteProgram(tubeProgram);
+    if(tubeBuffer) glDeleteBuffers(1, &tubeBuffer);
+    if(tubeTexture) glDeleteTextures(1, &tubeTexture);
+    
+    segmentProgram = 0;
+    instanceVBO = 0;
+    finVBO = 0;
+    tubeProgram = 0;
+    tubeBuffer = 0;
+    tubeTexture = 0;
+    tubeData.clear();
+    tubeCacheValid = false;
+    glContext = nullptr;
 }
 
-void Snake::updateDirections()
+void Snake::drawSegmentsInstanced()
 {
-    // 确保direction和upDirection保持垂直
-    upDirection = glm::normalize(upDirection - direction * glm::dot(direction, upDirection));
+    if(instanceData.empty()) return;
+    
+    // 上传本帧可见段的实例数据
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, instanceData.size() * sizeof(SegmentInstance), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, instanceData.size() * sizeof(SegmentInstance), instanceData.data());
+    
+    glUseProgram(segmentProgram);
+    setShadingUniforms(segmentProgram);
+    
+    // 实例属性
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(SegmentInstance), (void*)0);
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(SegmentInstance), (void*)(4 * sizeof(float)));
+    glVertexAttribDivisor(2, 1);
+    
+    // 单位球顶点
+    const SphereMesh& sphere = SphereMesh::get(INSTANCED_SPHERE_SECTORS, INSTANCED_SPHERE_STACKS);
+    if(!sphere.bindBuffers()) {
+        glDisableVertexAttribArray(1);
+        glDisableVertexAttribArray(2);
+        glVertexAttribDivisor(1, 0);
+        glVertexAttribDivisor(2, 0);
+        glUseProgram(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        return;
+    }
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+    
+    glDrawElementsInstanced(GL_TRIANGLES, sphere.getIndexCount(), GL_UNSIGNED_INT, nullptr,
+                            static_cast<GLsizei>(instanceData.size()));
+    RenderStats::countDraw();
+    
+    // 恢复状态，避免除数设置影响其他绘制
+    glVertexAttribDivisor(1, 0);
+    glVertexAttribDivisor(2, 0);
+    glDisableVertexAttribArray(0);
+    glDisableVertexAttribArray(1);
+    glDisableVertexAttribArray(2);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glUseProgram(0);
 }
 
-bool Snake::checkCollision(const glm::vec3& point) const
+void Snake::storePreviousState()
 {
-    for(const glm::vec3& segment : body) {
-        float distance = glm::length(segment - point);
-        if(distance < segmentSize * 1.5f) {  // 增加碰撞检测的容差
-            return true;
-        }
-    }
-    return false;
+    previousHead = body.front();
+    previousTail = body.back();
 }
 
-bool Snake::checkSelfCollision() const
+glm::vec3 Snake::renderPosition(size_t index) const
 {
-    // 显著增加忽略的节数以避免误判
-    const size_t IGNORE_SEGMENTS = 15;  // 增加忽略的节数
-    
-    if(body.size() <= IGNORE_SEGMENTS) return false;
-    
-    const glm::vec3& head = body[0];
-    
-    // 采用渐进式判定：距离头部越远的段，碰撞范围越大
-    for(size_t i = IGNORE_SEGMENTS; i < body.size(); ++i) {
-        float distance = glm::length(head - body[i]);
-        float collisionThreshold = segmentSize * (0.5f + static_cast<float>(i) / body.size() * 0.3f);
-        
-        if(distance < collisionThreshold) {
-            return true;
-        }
-    }
-    return false;
+    // 中间的采样点位置固定不变，只有蛇头和蛇尾需要在两帧之间插值
+    if(index == 0) return glm::mix(previousHead, body.front(), renderAlpha);
+    if(index == body.size() - 1) return glm::mix(previousTail, body.back(), renderAlpha);
+    return body[index];
 }
 
 void Snake::setGradientColor(float t) const {
@@ -142,9 +344,7 @@ void Snake::setGradientColor(float t) const {
     glColor3f(r, g, b);
 }
 
-void Snake::drawDorsalFin(const glm::vec3& pos, const glm::vec3& dir, const glm::vec3& up, float size) {
-    glm::vec3 right = glm::normalize(glm::cross(dir, up));
-    
+void Snake::appendDorsalFin(const glm::vec3& pos, const glm::vec3& dir, const glm::vec3& up, float size) {
     // 计算背鳍的基准点（从蛇身体表面开始）
     glm::vec3 finBase = pos + up * size;  // 从球体表面开始
     
@@ -153,30 +353,55 @@ void Snake::drawDorsalFin(const glm::vec3& pos, const glm::vec3& dir, const glm:
     glm::vec3 finFrontBase = finBase + dir * (size * FIN_LENGTH_RATIO * 0.5f);
     glm::vec3 finBackBase = finBase - dir * (size * FIN_LENGTH_RATIO * 0.5f);
     
-    // 设置背鳍材质
+    glm::vec3 normal = glm::normalize(glm::cross(dir, up));
+    const glm::vec3 topColor(GRADIENT_TOP_R, GRADIENT_TOP_G, GRADIENT_TOP_B);
+    const glm::vec3 bottomColor(GRADIENT_BOTTOM_R, GRADIENT_BOTTOM_G, GRADIENT_BOTTOM_B);
+    
+    // 正面
+    finVertices.push_back({finTop, normal, topColor});
+    finVertices.push_back({finFrontBase, normal, bottomColor});
+    finVertices.push_back({finBackBase, normal, bottomColor});
+    
+    // 背面（反向绘制以确保双面可见）
+    finVertices.push_back({finTop, -normal, topColor});
+    finVertices.push_back({finBackBase, -normal, bottomColor});
+    finVertices.push_back({finFrontBase, -normal, bottomColor});
+}
+
+void Snake::drawFins()
+{
+    if(finVertices.empty()) return;
+    
+    // 设置背鳍材质，整帧只设置一次
     GLfloat finSpecular[] = { 0.8f, 0.8f, 0.8f, 1.0f };
     GLfloat finShininess[] = { 32.0f };
     glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, finSpecular);
     glMaterialfv(GL_FRONT_AND_BACK, GL_SHININESS, finShininess);
     
-    // 绘制背鳍（三角形）
-    glBegin(GL_TRIANGLES);
+    glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_NORMAL_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
     
-    // 正面
-    setGradientColor(1.0f);  // 顶部颜色
-    glVertex3fv(glm::value_ptr(finTop));
-    setGradientColor(0.0f);  // 底部颜色
-    glVertex3fv(glm::value_ptr(finFrontBase));
-    glVertex3fv(glm::value_ptr(finBackBase));
+    // 有动态缓冲区时上传到显存，否则直接使用客户端数组
+    const char* base = reinterpret_cast<const char*>(finVertices.data());
+    if(finVBO) {
+        glBindBuffer(GL_ARRAY_BUFFER, finVBO);
+        glBufferData(GL_ARRAY_BUFFER, finVertices.size() * sizeof(FinVertex), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, finVertices.size() * sizeof(FinVertex), finVertices.data());
+        base = nullptr;
+    }
+    glVertexPointer(3, GL_FLOAT, sizeof(FinVertex), base + offsetof(FinVertex, position));
+    glNormalPointer(GL_FLOAT, sizeof(FinVertex), base + offsetof(FinVertex, normal));
+    glColorPointer(3, GL_FLOAT, sizeof(FinVertex), base + offsetof(FinVertex, color));
     
-    // 背面（反向绘制以确保双面可见）
-    setGradientColor(1.0f);
-    glVertex3fv(glm::value_ptr(finTop));
-    setGradientColor(0.0f);
-    glVertex3fv(glm::value_ptr(finBackBase));
-    glVertex3fv(glm::value_ptr(finFrontBase));
+    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(finVertices.size()));
+    RenderStats::countDraw();
     
-    glEnd();
+    if(finVBO) {
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    glPopClientAttrib();
 }
 
 void Snake::extractFrustumPlanes() {
@@ -227,23 +452,59 @@ void Snake::extractFrustumPlanes() {
         frustumPlanes[i] /= length;
     }
 
+    frustumCuller.setPlanes(frustumPlanes);
     frustumPlanesUpdated = true;
 }
 
 bool Snake::isSegmentInFrustum(const glm::vec3& position, float radius) const {
-    // 对于每个平面
-    for(int i = 0; i < 6; ++i) {
-        float distance = frustumPlanes[i].x * position.x +
-                        frustumPlanes[i].y * position.y +
-                        frustumPlanes[i].z * position.z +
-                        frustumPlanes[i].w;
+    return frustumCuller.isSphereVisible(position, radius);
+}
+
+void Snake::cullSegments()
+{
+    visibleSegments.clear();
+    if(body.empty()) return;
+    
+    const float bodyRadius = segmentSize * 1.1f;
+    SnakeBody::SoaSpan spans[2];
+    const size_t spanCount = body.soaSpans(spans);
+    
+    // 先按组的包围盒剔除：完全在外的组整体跳过，完全在内的组直接全部加入，
+    // 只有与视锥体边界相交的组才在SoA镜像上逐段批量测试
+    chunkBounds.forEachChunk([&](const ChunkBounds::Chunk& chunk) {
+        FrustumCuller::Containment containment = frustumCuller.classifyBox(chunk.min, chunk.max, bodyRadius);
+        if(containment == FrustumCuller::OUTSIDE) return;
         
-        // 如果球体完全在平面的负面，则它在视锥体外
-        if(distance < -radius) {
-            return false;
+        const size_t first = body.indexOfSequence(chunk.headSequence);
+        if(containment == FrustumCuller::INSIDE) {
+            for(size_t i = 0; i < chunk.count; ++i) {
+                visibleSegments.push_back(static_cast<uint32_t>(first + i));
+            }
+            return;
+        }
+        
+        // 组可能跨越环形缓冲区的回绕点，按连续内存拆分
+        size_t begin = first;
+        const size_t end = first + chunk.count;
+        size_t spanStart = 0;
+        for(size_t s = 0; s < spanCount && begin < end; ++s) {
+            const size_t spanEnd = spanStart + spans[s].size;
+            if(begin < spanEnd) {
+                const size_t local = begin - spanStart;
+                const size_t n = std::min(end, spanEnd) - begin;
+                frustumCuller.cull(spans[s].x + local, spans[s].y + local, spans[s].z + local, n,
+                                   bodyRadius, static_cast<uint32_t>(begin), visibleSegments);
+                begin += n;
+            }
+            spanStart = spanEnd;
         }
+    });
+    
+    // 蛇头半径更大，单独按实际半径补测
+    bool headListed = !visibleSegments.empty() && visibleSegments.front() == 0;
+    if(!headListed && isSegmentInFrustum(body.front(), segmentSize * 1.3f)) {
+        visibleSegments.insert(visibleSegments.begin(), 0);
     }
-    return true;
 }
 
 void Snake::draw() {
@@ -251,6 +512,13 @@ void Snake::draw() {
     if(!frustumPlanesUpdated) {
         extractFrustumPlanes();
     }
+    
+    // 首次绘制时创建实例化渲染资源
+    if(!instancingInitialized) {
+        initInstancedRendering();
+    }
+    const bool useInstancing = segmentProgram != 0;
+    const bool useTube = useInstancing && tubeRendering && tubeProgram != 0;
 
     // 保存当前的OpenGL状态
     glPushAttrib(GL_ALL_ATTRIB_BITS);
@@ -262,39 +530,62 @@ void Snake::draw() {
     glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, matSpecular);
     glMaterialfv(GL_FRONT_AND_BACK, GL_SHININESS, matShininess);
     
+    instanceData.clear();
+    finVertices.clear();
+    
     // 绘制蛇的每个段
-    for(size_t i = 0; i < body.size(); ++i) {
-        // 进行视锥体剔除测试
+    const size_t bodySize = body.size();
+    // 批量视锥体剔除，只遍历可见的段
+    cullSegments();
+    for(uint32_t visibleIndex : visibleSegments) {
+        const size_t i = visibleIndex;
+        const glm::vec3 segmentPos = renderPosition(i);
         float segmentRadius = (i == 0) ? segmentSize * 1.3f : segmentSize * 1.1f;
-        if(!isSegmentInFrustum(body[i], segmentRadius)) {
-            continue; // 如果这个段不在视锥体内，跳过它的渲染
+        
+        // 蛇头使用顶部颜色，蛇身从头到尾逐渐变暗
+        float t = (i == 0) ? 1.0f : 1.0f - (float)i / bodySize * 0.3f;
+        
+        // 管状模式下只有蛇头和蛇尾端盖仍使用球体
+        if(useInstancing && (!useTube || i == 0 || i == bodySize - 1)) {
+            // 球体留到循环结束后一次性实例化绘制
+            SegmentInstance instance;
+            instance.position = segmentPos;
+            instance.radius = segmentRadius;
+            instance.gradient = t;
+            instanceData.push_back(instance);
         }
-
-        glPushMatrix();
-        glTranslatef(body[i].x, body[i].y, body[i].z);
         
-        // 计算当前段的方向
-        glm::vec3 segmentDir = (i < body.size() - 1) ? 
-            glm::normalize(body[i+1] - body[i]) : 
-            glm::normalize(body[i] - body[i-1]);
-            
-        if(i == 0) {
-            // 蛇头
-            setGradientColor(1.0f);
-            drawSphere(segmentSize * 1.3f, 24, 24);
-            drawDorsalFin(glm::vec3(0), direction, upDirection, segmentSize * 1.4f);
-        } else {
-            // 蛇身
-            float t = 1.0f - (float)i / body.size() * 0.3f;
+        if(!useInstancing) {
+            glPushMatrix();
+            glTranslatef(segmentPos.x, segmentPos.y, segmentPos.z);
             setGradientColor(t);
-            drawSphere(segmentSize * 1.1f, 20, 20);
-            
-            if(i % 2 == 0) {
-                drawDorsalFin(glm::vec3(0), segmentDir, upDirection, segmentSize * 0.9f);
-            }
+            drawSphere(segmentRadius, i == 0 ? 24 : 20, i == 0 ? 24 : 20);
+            glPopMatrix();
         }
         
-        glPopMatrix();
+        // 采样点间距即为 segmentSize，每个点都有背鳍，蛇尾端点除外
+        if(i == 0) {
+            appendDorsalFin(segmentPos, direction, upDirection, segmentSize * 1.4f);
+        } else if(i + 1 < bodySize) {
+            // 蛇头恰好落在采样点上时相邻两点可能重合，此时沿用蛇的朝向
+            glm::vec3 segmentDelta = renderPosition(i + 1) - segmentPos;
+            glm::vec3 segmentDir = glm::dot(segmentDelta, segmentDelta) > 1e-6f ?
+                glm::normalize(segmentDelta) : -direction;
+            appendDorsalFin(segmentPos, segmentDir, upDirection, segmentSize * 0.9f);
+        }
+    }
+    
+    // 所有背鳍合并为一次绘制
+    drawFins();
+    
+    if(useInstancing) {
+        // 背鳍修改了材质，绘制球体前恢复蛇身材质
+        glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, matSpecular);
+        glMaterialfv(GL_FRONT_AND_BACK, GL_SHININESS, matShininess);
+        if(useTube) {
+            drawTube();
+        }
+        drawSegmentsInstanced();
     }
     
     // 恢复OpenGL状态
@@ -305,53 +596,242 @@ void Snake::draw() {
     frustumPlanesUpdated = false;
 }
 
-void Snake::drawSphere(float radius, int sectors, int stacks)  // 移除 const 限定符
+void Snake::setShadingUniforms(GLuint program)
 {
-    const float PI = 3.14159265359f;
-    
-    glBegin(GL_TRIANGLES);
-    for(int i = 0; i < stacks; ++i) {
-        float phi1 = PI * float(i) / float(stacks);
-        float phi2 = PI * float(i + 1) / float(stacks);
-        
-        for(int j = 0; j < sectors; ++j) {
-            float theta1 = 2.0f * PI * float(j) / float(sectors);
-            float theta2 = 2.0f * PI * float(j + 1) / float(sectors);
-            
-            // 第一个三角形
-            glVertex3f(
-                radius * sin(phi1) * cos(theta1),
-                radius * cos(phi1),
-                radius * sin(phi1) * sin(theta1)
-            );
-            glVertex3f(
-                radius * sin(phi2) * cos(theta1),
-                radius * cos(phi2),
-                radius * sin(phi2) * sin(theta1)
-            );
-            glVertex3f(
-                radius * sin(phi2) * cos(theta2),
-                radius * cos(phi2),
-                radius * sin(phi2) * sin(theta2)
-            );
-            
-            // 第二个三角形
-            glVertex3f(
-                radius * sin(phi1) * cos(theta1),
-                radius * cos(phi1),
-                radius * sin(phi1) * sin(theta1)
-            );
-            glVertex3f(
-                radius * sin(phi2) * cos(theta2),
-                radius * cos(phi2),
-                radius * sin(phi2) * sin(theta2)
-            );
-            glVertex3f(
-                radius * sin(phi1) * cos(theta2),
-                radius * cos(phi1),
-                radius * sin(phi1) * sin(theta2)
-            );
+    GLint lightMask = 0;
+    for(int i = 0; i < 8; ++i) {
+        if(glIsEnabled(GL_LIGHT0 + i)) lightMask |= (1 << i);
+    }
+    glUniform1i(glGetUniformLocation(program, "lightMask"), lightMask);
+    glUniform1i(glGetUniformLocation(program, "fogEnabled"), glIsEnabled(GL_FOG) ? 1 : 0);
+    glUniform3f(glGetUniformLocation(program, "gradientTop"), GRADIENT_TOP_R, GRADIENT_TOP_G, GRADIENT_TOP_B);
+    glUniform3f(glGetUniformLocation(program, "gradientBottom"), GRADIENT_BOTTOM_R, GRADIENT_BOTTOM_G, GRADIENT_BOTTOM_B);
+}
+
+glm::vec3 Snake::tubeTangent(size_t index, const glm::vec3& fallback) const
+{
+    // 切线取相邻两点的中心差分（从头指向尾），重合的点沿用给定的切线
+    const size_t ringCount = body.size();
+    glm::vec3 diff = renderPosition(index + 1 < ringCount ? index + 1 : index) -
+                     renderPosition(index == 0 ? 0 : index - 1);
+    float diffLength2 = glm::dot(diff, diff);
+    return diffLength2 > 1e-6f ? diff / std::sqrt(diffLength2) : fallback;
+}
+
+void Snake::writeTubeRing(uint64_t sequence, size_t index, const glm::vec3& tangent, const glm::vec3& normal)
+{
+    const size_t slot = static_cast<size_t>(sequence & tubeMask) * TUBE_TEXELS_PER_RING;
+    tubeData[slot] = glm::vec4(renderPosition(index), 0.0f);
+    tubeData[slot + 1] = glm::vec4(normal, 0.0f);
+    tubeData[slot + 2] = glm::vec4(glm::cross(tangent, normal), 0.0f);
+}
+
+void Snake::startTubeRing(uint64_t sequence, size_t index)
+{
+    // 初始法线取蛇的上方向在截面内的投影
+    glm::vec3 tangent = tubeTangent(index, -direction);
+    glm::vec3 normal = upDirection - glm::dot(upDirection, tangent) * tangent;
+    if(glm::dot(normal, normal) < 1e-6f) {
+        glm::vec3 axis = std::fabs(tangent.x) < 0.9f ? glm::vec3(1, 0, 0) : glm::vec3(0, 1, 0);
+        normal = glm::cross(tangent, axis);
+    }
+    writeTubeRing(sequence, index, tangent, glm::normalize(normal));
+}
+
+void Snake::transportTubeRing(uint64_t fromSequence, uint64_t sequence, size_t index)
+{
+    // 从已写入的相邻环出发，用双反射法近似平行移动，截面不会绕路径扭转
+    const size_t from = static_cast<size_t>(fromSequence & tubeMask) * TUBE_TEXELS_PER_RING;
+    const glm::vec3 prevPosition(tubeData[from]);
+    const glm::vec3 prevNormal(tubeData[from + 1]);
+    const glm::vec3 prevTangent = glm::cross(prevNormal, glm::vec3(tubeData[from + 2]));
+
+    const glm::vec3 tangent = tubeTangent(index, prevTangent);
+    glm::vec3 v1 = renderPosition(index) - prevPosition;
+    float c1 = glm::dot(v1, v1);
+    glm::vec3 reflectedNormal = prevNormal;
+    glm::vec3 reflectedTangent = prevTangent;
+    if(c1 > 1e-6f) {
+        reflectedNormal -= (2.0f / c1) * glm::dot(v1, reflectedNormal) * v1;
+        reflectedTangent -= (2.0f / c1) * glm::dot(v1, reflectedTangent) * v1;
+    }
+    glm::vec3 v2 = tangent - reflectedTangent;
+    float c2 = glm::dot(v2, v2);
+    if(c2 > 1e-6f) {
+        reflectedNormal -= (2.0f / c2) * glm::dot(v2, reflectedNormal) * v2;
+    }
+    // 重新正交化，抵消浮点误差累积
+    glm::vec3 normal = reflectedNormal - glm::dot(reflectedNormal, tangent) * tangent;
+    if(glm::dot(normal, normal) < 1e-6f) {
+        startTubeRing(sequence, index);
+        return;
+    }
+    writeTubeRing(sequence, index, tangent, glm::normalize(normal));
+}
+
+void Snake::uploadTubeRings(uint64_t firstSequence, uint64_t lastSequence)
+{
+    // 序号连续的环在缓冲区中至多分成两段（跨过末尾时回绕）
+    const size_t capacity = tubeMask + 1;
+    const size_t ringBytes = TUBE_TEXELS_PER_RING * sizeof(glm::vec4);
+    size_t slot = static_cast<size_t>(firstSequence & tubeMask);
+    size_t count = static_cast<size_t>(lastSequence - firstSequence) + 1;
+    while(count > 0) {
+        size_t n = std::min(count, capacity - slot);
+        glBufferSubData(GL_TEXTURE_BUFFER, slot * ringBytes, n * ringBytes,
+                        tubeData.data() + slot * TUBE_TEXELS_PER_RING);
+        count -= n;
+        slot = 0;
+    }
+}
+
+void Snake::buildTubeFrames()
+{
+    const size_t ringCount = body.size();
+    const uint64_t headSeq = body.headSequence();
+    const uint64_t tailSeq = body.tailSequence();
+
+    glBindBuffer(GL_TEXTURE_BUFFER, tubeBuffer);
+
+    // 容量不足时按2的幂扩容，已算好的固定环搬到新的槽位，之后整体重新上传
+    bool reallocated = false;
+    if(tubeData.size() < ringCount * TUBE_TEXELS_PER_RING) {
+        size_t capacity = 1;
+        while(capacity < ringCount) capacity <<= 1;
+        std::vector<glm::vec4> previous(capacity * TUBE_TEXELS_PER_RING, glm::vec4(0.0f));
+        previous.swap(tubeData);
+        const size_t previousMask = tubeMask;
+        tubeMask = capacity - 1;
+        if(tubeCacheValid) {
+            for(uint64_t s = tailSeq + 1; s <= tubeCachedThrough; ++s) {
+                std::copy_n(previous.begin() + (s & previousMask) * TUBE_TEXELS_PER_RING, TUBE_TEXELS_PER_RING,
+                            tubeData.begin() + (s & tubeMask) * TUBE_TEXELS_PER_RING);
+            }
         }
+        glBufferData(GL_TEXTURE_BUFFER, tubeData.size() * sizeof(glm::vec4), nullptr, GL_DYNAMIC_DRAW);
+        reallocated = true;
     }
-    glEnd();
-}
\ No newline at end of file
+
+    // 两侧相邻点都是固定采样点的环，其标架此后不再变化，序号区间为 [tailSeq+1, headSeq-2]；
+    // 每个逻辑帧只需从上次的最新环平行移动到新压入的环，并只上传这部分
+    if(ringCount >= 4) {
+        const uint64_t firstFixed = tailSeq + 1;
+        const uint64_t lastFixed = headSeq - 2;
+        uint64_t first = tubeCachedThrough + 1;
+        if(!tubeCacheValid || tubeCachedThrough < firstFixed || tubeCachedThrough > lastFixed) {
+            // 首次绘制、扩容或缓存的环已全部被蛇尾越过：从最老的环开始重新计算
+            first = firstFixed;
+            startTubeRing(first, body.indexOfSequence(first));
+        } else if(first <= lastFixed) {
+            transportTubeRing(first - 1, first, body.indexOfSequence(first));
+        }
+        for(uint64_t s = first + 1; s <= lastFixed; ++s) {
+            transportTubeRing(s - 1, s, body.indexOfSequence(s));
+        }
+        if(reallocated) {
+            uploadTubeRings(firstFixed, lastFixed);
+        } else if(first <= lastFixed) {
+            uploadTubeRings(first, lastFixed);
+        }
+        tubeCachedThrough = lastFixed;
+        tubeCacheValid = true;
+    } else {
+        tubeCacheValid = false;
+    }
+
+    // 每帧重算依赖插值位置的环：紧邻蛇头的环、蛇头，以及从最老的环移动到的蛇尾
+    if(ringCount >= 4) {
+        transportTubeRing(headSeq - 2, headSeq - 1, 1);
+    } else if(ringCount == 3) {
+        startTubeRing(headSeq - 1, 1);
+    }
+    if(ringCount >= 3) {
+        transportTubeRing(headSeq - 1, headSeq, 0);
+        uploadTubeRings(headSeq - 1, headSeq);
+    } else {
+        startTubeRing(headSeq, 0);
+        uploadTubeRings(headSeq, headSeq);
+    }
+    transportTubeRing(tailSeq + 1, tailSeq, ringCount - 1);
+    uploadTubeRings(tailSeq, tailSeq);
+}
+
+void Snake::drawTube()
+{
+    const size_t ringCount = body.size();
+    if(ringCount < 2) return;
+
+    buildTubeFrames();
+
+    // 只提交至少一端可见的环间区段，相邻区段合并，直接由可见段列表生成，
+    // 顶点数与可见长度成正比，所有区段在一次 glMultiDrawArrays 中完成
+    const GLsizei verticesPerSpan = TUBE_SIDES * 6;
+    tubeFirsts.clear();
+    tubeCounts.clear();
+    size_t nextSpan = 0;    // 尚未加入的最小区段下标，可见段从头到尾有序
+    for(uint32_t visibleIndex : visibleSegments) {
+        for(size_t i = visibleIndex > 0 ? visibleIndex - 1 : 0; i <= visibleIndex && i + 1 < ringCount; ++i) {
+            if(i < nextSpan) continue;
+            nextSpan = i + 1;
+
+            GLint first = static_cast<GLint>(i) * verticesPerSpan;
+            if(!tubeFirsts.empty() && tubeFirsts.back() + tubeCounts.back() == first) {
+                tubeCounts.back() += verticesPerSpan;
+            } else {
+                tubeFirsts.push_back(first);
+                tubeCounts.push_back(verticesPerSpan);
+            }
+        }
+    }
+    if(tubeFirsts.empty()) {
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+        return;
+    }
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_BUFFER, tubeTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, tubeBuffer);
+
+    glUseProgram(tubeProgram);
+    setShadingUniforms(tubeProgram);
+    glUniform1i(glGetUniformLocation(tubeProgram, "ringData"), 0);
+    glUniform1i(glGetUniformLocation(tubeProgram, "headSlot"), static_cast<GLint>(body.headSequence() & tubeMask));
+    glUniform1i(glGetUniformLocation(tubeProgram, "slotMask"), static_cast<GLint>(tubeMask));
+    glUniform1i(glGetUniformLocation(tubeProgram, "ringCount"), static_cast<GLint>(ringCount));
+    glUniform1i(glGetUniformLocation(tubeProgram, "sides"), TUBE_SIDES);
+    glUniform1f(glGetUniformLocation(tubeProgram, "radius"), segmentSize * 1.1f);
+
+    // 不需要顶点属性，顶点位置全部由 gl_VertexID 推导
+    glMultiDrawArrays(GL_TRIANGLES, tubeFirsts.data(), tubeCounts.data(),
+                      static_cast<GLsizei>(tubeFirsts.size()));
+    RenderStats::countDraw();
+
+    glUseProgram(0);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void Snake::drawSphere(float radius, int sectors, int stacks)  // 移除 const 限定符
+{
+    SphereMesh::get(sectors, stacks).draw(radius);
+}
+
+void Snake::reportMemory(MemoryReport& report) const
+{
+    SnakeCore::reportMemory(report);
+
+    MemoryUsage renderData = vectorMemory(instanceData);
+    renderData += vectorMemory(finVertices);
+    renderData += vectorMemory(tubeData);
+    renderData += vectorMemory(tubeFirsts);
+    renderData += vectorMemory(tubeCounts);
+    renderData += vectorMemory(visibleSegments);
+    report.add("snake.render_data", renderData);
+
+    // 动态缓冲区每帧按本帧数据重新分配，大小即上次上传的数据量；管状缓冲区按环的容量分配
+    size_t gpuBytes = 0;
+    if(instanceVBO) gpuBytes += instanceData.size() * sizeof(SegmentInstance);
+    if(finVBO) gpuBytes += finVertices.size() * sizeof(FinVertex);
+    if(tubeBuffer) gpuBytes += tubeData.size() * sizeof(glm::vec4);
+    report.add("gpu.snake.buffers", gpuMemory(gpuBytes));
+}
@@ -0,0 +1,138 @@
+#include "snakebody.h"
+
+static constexpr size_t INITIAL_CAPACITY = 64;
+
+SnakeBody::SnakeBody()
+    : storage(INITIAL_CAPACITY)
+    , xs(INITIAL_CAPACITY)
+    , ys(INITIAL_CAPACITY)
+    , zs(INITIAL_CAPACITY)
+    , head(0)
+    , count(0)
+    , mask(INITIAL_CAPACITY - 1)
+    , headSeq(0)
+{
+}
+
+void SnakeBody::clear()
+{
+    head = 0;
+    count = 0;
+    headSeq = 0;
+}
+
+void SnakeBody::pushBack(const glm::vec3& pos)
+{
+    reserveFor(count + 1);
+    store((head + count) & mask, pos);
+    ++count;
+}
+
+void SnakeBody::pushFront(const glm::vec3& pos)
+{
+    reserveFor(count + 1);
+
+    // 头指针后退一格写入新蛇头
+    head = (head + mask) & mask;
+    store(head, pos);
+    ++count;
+    ++headSeq;
+}
+
+void SnakeBody::popFront()
+{
+    if(count == 0) return;
+    head = (head + 1) & mask;
+    --count;
+    --headSeq;
+}
+
+void SnakeBody::popBack()
+{
+    if(count == 0) return;
+    --count;
+}
+
+void SnakeBody::store(size_t slot, const glm::vec3& pos)
+{
+    storage[slot] = pos;
+    xs[slot] = pos.x;
+    ys[slot] = pos.y;
+    zs[slot] = pos.z;
+}
+
+size_t SnakeBody::spans(Span out[2]) const
+{
+    if(count == 0) return 0;
+
+    size_t firstSize = storage.size() - head;
+    if(firstSize >= count) {
+        out[0].data = storage.data() + head;
+        out[0].size = count;
+        return 1;
+    }
+
+    out[0].data = storage.data() + head;
+    out[0].size = firstSize;
+    out[1].data = storage.data();
+    out[1].size = count - firstSize;
+    return 2;
+}
+
+size_t SnakeBody::soaSpans(SoaSpan out[2]) const
+{
+    if(count == 0) return 0;
+
+    size_t firstSize = storage.size() - head;
+    out[0].x = xs.data() + head;
+    out[0].y = ys.data() + head;
+    out[0].z = zs.data() + head;
+    if(firstSize >= count) {
+        out[0].size = count;
+        return 1;
+    }
+
+    out[0].size = firstSize;
+    out[1].x = xs.data();
+    out[1].y = ys.data();
+    out[1].z = zs.data();
+    out[1].size = count - firstSize;
+    return 2;
+}
+
+void SnakeBody::reserveFor(size_t required)
+{
+    if(required <= storage.size()) return;
+
+    size_t newCapacity = storage.size();
+    while(newCapacity < required) {
+        newCapacity *= 2;
+    }
+
+    // 扩容时将数据按逻辑顺序重排，头部回到0
+    std::vector<glm::vec3> newStorage(newCapacity);
+    std::vector<float> newXs(newCapacity), newYs(newCapacity), newZs(newCapacity);
+    for(size_t i = 0; i < count; ++i) {
+        const glm::vec3& pos = (*this)[i];
+        newStorage[i] = pos;
+        newXs[i] = pos.x;
+        newYs[i] = pos.y;
+        newZs[i] = pos.z;
+    }
+
+    storage.swap(newStorage);
+    xs.swap(newXs);
+    ys.swap(newYs);
+    zs.swap(newZs);
+    head = 0;
+    mask = newCapacity - 1;
+}
+
+MemoryUsage SnakeBody::memoryUsage() const
+{
+    MemoryUsage usage;
+    usage.size = count * (sizeof(glm::vec3) + 3 * sizeof(float));
+    usage.capacity = storage.capacity() * sizeof(glm::vec3)
+                   + (xs.capacity() + ys.capacity() + zs.capacity()) * sizeof(float);
+    return usage;
+}
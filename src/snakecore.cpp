@@ -0,0 +1,223 @@
+#define GLM_ENABLE_EXPERIMENTAL
+#include "snakecore.h"
+#include <cmath>
+#include <algorithm>
+
+SnakeCore::SnakeCore(float x, float y, float z, int initialLength)
+    : segmentHash(DEFAULT_SEGMENT_SIZE)
+    , direction(1.0f, 0.0f, 0.0f)
+    , targetDirection(direction)
+    , upDirection(0.0f, 1.0f, 0.0f)
+    , segmentSize(DEFAULT_SEGMENT_SIZE)
+    , moveSpeed(DEFAULT_MOVE_SPEED)
+{
+    // 设置初始位置
+    glm::vec3 initialPos(x, y, z);
+    
+    // 初始长度默认为3节，每节对应蛇头一次移动的距离
+    length = (std::max(initialLength, 1) - 1) * moveSpeed;
+    pendingGrowth = 0.0f;
+    
+    // 假定蛇头此前沿+X方向行进了 length，蛇尾位于弧长0处
+    odometer = length;
+    tailAnchor = initialPos - glm::vec3(length, 0.0f, 0.0f);
+    tailAnchorOdometer = 0.0;
+    nextSampleIndex = static_cast<uint64_t>(std::floor(odometer / segmentSize)) + 1;
+    oldestSampleIndex = 1;
+    // 从蛇尾向蛇头依次压入，段序号保持递增，不会在蛇尾一侧下溢
+    body.pushFront(tailAnchor);
+    for(uint64_t k = oldestSampleIndex; k < nextSampleIndex; ++k) {
+        body.pushFront(tailAnchor + glm::vec3(k * segmentSize, 0.0f, 0.0f));
+    }
+    body.pushFront(initialPos);
+    for(size_t i = 0; i < body.size(); ++i) {
+        indexSegment(body.headSequence() - i, body[i]);
+    }
+    chunkBounds.refit(body);
+}
+
+void SnakeCore::move()
+{
+    // 平滑转向，但速度更快
+    if (glm::length(targetDirection - direction) > 0.01f) {
+        direction = glm::normalize(
+            glm::mix(direction, targetDirection, TURN_SPEED)
+        );
+        updateDirections();
+    }
+
+    // 更新蛇的位置
+    const glm::vec3 oldHead = body.front();
+    const glm::vec3 newHead = oldHead + direction * moveSpeed;
+    const double oldOdometer = odometer;
+    odometer += moveSpeed;
+    
+    // 蛇头是移动端点，先移出，插入本步越过的采样点后再放回
+    unindexSegment(body.headSequence(), oldHead);
+    body.popFront();
+    
+    const double spacing = segmentSize;
+    while(nextSampleIndex * spacing <= odometer) {
+        float t = static_cast<float>((nextSampleIndex * spacing - oldOdometer) / moveSpeed);
+        glm::vec3 sample = glm::mix(oldHead, newHead, t);
+        body.pushFront(sample);
+        indexSegment(body.headSequence(), sample);
+        ++nextSampleIndex;
+    }
+    
+    body.pushFront(newHead);
+    indexSegment(body.headSequence(), newHead);
+    
+    // 有待增长量时蛇尾停留不动，与旧版在尾部重复添加段的效果一致
+    float growth = std::min(pendingGrowth, moveSpeed);
+    pendingGrowth -= growth;
+    length += growth;
+    const double tailOdometer = odometer - length;
+    
+    unindexSegment(body.tailSequence(), body.back());
+    body.popBack();
+    
+    // 移除已被蛇尾越过的采样点，最后一个作为插值锚点
+    while(oldestSampleIndex < nextSampleIndex && oldestSampleIndex * spacing <= tailOdometer) {
+        tailAnchor = body.back();
+        tailAnchorOdometer = oldestSampleIndex * spacing;
+        unindexSegment(body.tailSequence(), body.back());
+        body.popBack();
+        ++oldestSampleIndex;
+    }
+    
+    // 蛇尾在锚点与下一个点（最老的采样点或蛇头）之间按弧长插值
+    double nextOdometer = oldestSampleIndex < nextSampleIndex ? oldestSampleIndex * spacing : odometer;
+    double span = nextOdometer - tailAnchorOdometer;
+    float t = span > 1e-6 ? static_cast<float>((tailOdometer - tailAnchorOdometer) / span) : 1.0f;
+    glm::vec3 tail = glm::mix(tailAnchor, body.back(), glm::clamp(t, 0.0f, 1.0f));
+    body.pushBack(tail);
+    indexSegment(body.tailSequence(), tail);
+    chunkBounds.refit(body);
+}
+
+void SnakeCore::indexSegment(uint64_t sequence, const glm::vec3& position)
+{
+    segmentHash.insert(sequence, position);
+    chunkBounds.markDirty(sequence);
+}
+
+void SnakeCore::unindexSegment(uint64_t sequence, const glm::vec3& position)
+{
+    segmentHash.remove(sequence, position);
+    chunkBounds.markDirty(sequence);
+}
+
+void SnakeCore::grow()
+{
+    // 每次增长一次移动的距离，之后的移动中蛇尾停留直到增长完成
+    pendingGrowth += moveSpeed;
+}
+
+int SnakeCore::getLength() const
+{
+    // 以蛇头移动步数计的长度，与按每步一段存储时的段数一致
+    return static_cast<int>(std::lround((length + pendingGrowth) / moveSpeed)) + 1;
+}
+
+double SnakeCore::arcPosition(size_t index) const
+{
+    // 返回body中第index个点的累计弧长（蛇头为odometer）
+    if(index == 0) return odometer;
+    if(index == body.size() - 1) return odometer - length;
+    return static_cast<double>(nextSampleIndex - index) * segmentSize;
+}
+
+void SnakeCore::setDirection(const glm::vec3& newDir)
+{
+    if (glm::length(newDir) < 0.01f) return;
+
+    // 保存旧的方向用于平滑过渡
+    glm::vec3 oldDirection = direction;
+    
+    // 规范化新方向
+    targetDirection = glm::normalize(newDir);
+    
+    // 使用glm::rotate函数代替四元数直接操作
+    float angle = glm::acos(glm::dot(glm::normalize(oldDirection), targetDirection));
+    if (angle > 0.01f) {  // 确保有足够的角度差异
+        glm::vec3 rotationAxis = glm::cross(oldDirection, targetDirection);
+        if (glm::length(rotationAxis) > 0.01f) {  // 确保旋转轴有效
+            upDirection = glm::rotate(upDirection, angle, glm::normalize(rotationAxis));
+        }
+    }
+}
+
+void SnakeCore::rotateAroundAxis(const glm::vec3& axis, float angle)
+{
+    // 使用glm::rotate函数进行旋转
+    glm::vec3 normalizedAxis = glm::normalize(axis);
+    direction = glm::rotate(direction, angle, normalizedAxis);
+    upDirection = glm::rotate(upDirection, angle, normalizedAxis);
+    targetDirection = direction;
+}
+
+void SnakeCore::updateDirections()
+{
+    // 确保direction和upDirection保持垂直
+    upDirection = glm::normalize(upDirection - direction * glm::dot(direction, upDirection));
+}
+
+bool SnakeCore::checkCollision(const glm::vec3& point) const
+{
+    const float collisionRadius = segmentSize * 1.5f;  // 增加碰撞检测的容差
+    const float radiusSq = collisionRadius * collisionRadius;
+    
+    // 只检查查询点附近单元中的段
+    return segmentHash.visit(point, collisionRadius, [&](const SegmentHash::Entry& entry) {
+        glm::vec3 d = entry.position - point;
+        return glm::dot(d, d) < radiusSq;
+    });
+}
+
+// 点p在线段ab上最近点的参数，范围[0, 1]
+static float closestSegmentParameter(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b)
+{
+    glm::vec3 ab = b - a;
+    float lengthSq = glm::dot(ab, ab);
+    if(lengthSq < 1e-6f) return 0.0f;
+    return glm::clamp(glm::dot(p - a, ab) / lengthSq, 0.0f, 1.0f);
+}
+
+bool SnakeCore::checkSelfCollision() const
+{
+    // 忽略蛇头附近的一段弧长以避免误判（原先为15个每步一段的采样点）
+    const float IGNORE_DISTANCE = 15.0f * moveSpeed;
+    
+    if(length <= IGNORE_DISTANCE || body.size() < 2) return false;
+    
+    const glm::vec3 head = body.front();
+    
+    // 渐进阈值的上限为 segmentSize * 0.8；采样点间距不超过 segmentSize，
+    // 以线段起点查询时再扩大一个间距即可覆盖所有可能相交的线段
+    const float maxThreshold = segmentSize * 0.8f;
+    
+    // 检测蛇头到相邻采样点之间线段的距离，采用渐进式判定：距离头部越远，碰撞范围越大
+    return segmentHash.visit(head, maxThreshold + segmentSize, [&](const SegmentHash::Entry& entry) {
+        size_t i = body.indexOfSequence(entry.sequence);
+        if(i + 1 >= body.size()) return false;
+        
+        const glm::vec3& next = body[i + 1];
+        float u = closestSegmentParameter(head, entry.position, next);
+        float arcStart = static_cast<float>(odometer - arcPosition(i));
+        float arcEnd = static_cast<float>(odometer - arcPosition(i + 1));
+        float arcDistance = arcStart + (arcEnd - arcStart) * u;
+        if(arcDistance < IGNORE_DISTANCE) return false;
+        
+        float collisionThreshold = segmentSize * (0.5f + arcDistance / length * 0.3f);
+        glm::vec3 d = head - glm::mix(entry.position, next, u);
+        return glm::dot(d, d) < collisionThreshold * collisionThreshold;
+    });
+}
+
+void SnakeCore::reportMemory(MemoryReport& report) const
+{
+    report.add("snake.body", body.memoryUsage());
+    report.add("snake.segment_hash", segmentHash.memoryUsage());
+    report.add("snake.chunk_bounds", chunkBounds.memoryUsage());
+}
@@ -0,0 +1,172 @@
+#include "spheremesh.h"
+#include "renderstats.h"
+#include "logging.h"
+#include <QOpenGLContext>
+#include <cmath>
+
+std::map<std::pair<int, int>, std::unique_ptr<SphereMesh>> SphereMesh::cache;
+
+const SphereMesh& SphereMesh::get(int sectors, int stacks)
+{
+    std::pair<int, int> key(sectors, stacks);
+    auto it = cache.find(key);
+    if(it == cache.end()) {
+        it = cache.emplace(key, std::unique_ptr<SphereMesh>(new SphereMesh(sectors, stacks))).first;
+    }
+    return *it->second;
+}
+
+SphereMesh::SphereMesh(int sectors, int stacks)
+    : sectors(sectors)
+    , stacks(stacks)
+{
+    // 游戏中实际使用的细分级别走编译期三角表，其余在运行时计算一次
+    if(sectors == 16 && stacks == 16) {
+        buildFromTable<16, 16>();
+    } else if(sectors == 20 && stacks == 20) {
+        buildFromTable<20, 20>();
+    } else if(sectors == 24 && stacks == 24) {
+        buildFromTable<24, 24>();
+    } else {
+        buildRuntime();
+    }
+    buildIndices();
+}
+
+template<int Sectors, int Stacks>
+void SphereMesh::buildFromTable()
+{
+    static constexpr SphereTrig::Table<Sectors, Stacks> table{};
+
+    vertices.clear();
+    vertices.reserve((Stacks + 1) * (Sectors + 1));
+    for(int i = 0; i <= Stacks; ++i) {
+        for(int j = 0; j <= Sectors; ++j) {
+            vertices.push_back(glm::vec3(table.sinPhi[i] * table.cosTheta[j],
+                                         table.cosPhi[i],
+                                         table.sinPhi[i] * table.sinTheta[j]));
+        }
+    }
+}
+
+void SphereMesh::buildRuntime()
+{
+    vertices.clear();
+    vertices.reserve((stacks + 1) * (sectors + 1));
+    for(int i = 0; i <= stacks; ++i) {
+        float phi = static_cast<float>(SphereTrig::PI) * float(i) / float(stacks);
+        float sinPhi = std::sin(phi);
+        float cosPhi = std::cos(phi);
+        for(int j = 0; j <= sectors; ++j) {
+            float theta = 2.0f * static_cast<float>(SphereTrig::PI) * float(j) / float(sectors);
+            vertices.push_back(glm::vec3(sinPhi * std::cos(theta), cosPhi, sinPhi * std::sin(theta)));
+        }
+    }
+}
+
+void SphereMesh::buildIndices()
+{
+    indices.clear();
+    indices.reserve(stacks * sectors * 6);
+    for(int i = 0; i < stacks; ++i) {
+        for(int j = 0; j < sectors; ++j) {
+            GLuint k1 = i * (sectors + 1) + j;
+            GLuint k2 = k1 + sectors + 1;
+
+            indices.push_back(k1);
+            indices.push_back(k2);
+            indices.push_back(k2 + 1);
+
+            indices.push_back(k1);
+            indices.push_back(k2 + 1);
+            indices.push_back(k1 + 1);
+        }
+    }
+}
+
+bool SphereMesh::bindBuffers() const
+{
+    QOpenGLContext* context = QOpenGLContext::currentContext();
+    if(!context) return false;
+
+    // 缓冲区在共享上下文之间通用，因此按上下文组缓存
+    QOpenGLContextGroup* group = context->shareGroup();
+    auto it = gpuBuffers.find(group);
+    if(it == gpuBuffers.end()) {
+        GpuBuffers buffers;
+        glGenBuffers(1, &buffers.vbo);
+        glBindBuffer(GL_ARRAY_BUFFER, buffers.vbo);
+        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(glm::vec3),
+                     vertices.data(), GL_STATIC_DRAW);
+
+        glGenBuffers(1, &buffers.ibo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers.ibo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint),
+                     indices.data(), GL_STATIC_DRAW);
+
+        if(buffers.vbo == 0 || buffers.ibo == 0) {
+            AQ_WARNING(lcGame) << "Failed to create sphere mesh buffers" << sectors << "x" << stacks;
+            return false;
+        }
+
+        // 上下文组销毁时其中的缓冲区随之失效，移除记录以免指针被复用
+        QObject::connect(group, &QObject::destroyed, [this, group]() {
+            gpuBuffers.erase(group);
+        });
+
+        gpuBuffers.insert(std::make_pair(group, buffers));
+        return true;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, it->second.vbo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, it->second.ibo);
+    return true;
+}
+
+void SphereMesh::draw(float radius) const
+{
+    glPushMatrix();
+    glScalef(radius, radius, radius);
+
+    // 等比缩放后重新归一化法线
+    glPushAttrib(GL_ENABLE_BIT);
+    glEnable(GL_RESCALE_NORMAL);
+
+    glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_NORMAL_ARRAY);
+
+    // 单位球的顶点位置即为法线，两者共用同一份数据
+    if(bindBuffers()) {
+        glVertexPointer(3, GL_FLOAT, sizeof(glm::vec3), nullptr);
+        glNormalPointer(GL_FLOAT, sizeof(glm::vec3), nullptr);
+        glDrawElements(GL_TRIANGLES, getIndexCount(), GL_UNSIGNED_INT, nullptr);
+        RenderStats::countDraw();
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    } else {
+        glVertexPointer(3, GL_FLOAT, sizeof(glm::vec3), vertices.data());
+        glNormalPointer(GL_FLOAT, sizeof(glm::vec3), vertices.data());
+        glDrawElements(GL_TRIANGLES, getIndexCount(), GL_UNSIGNED_INT, indices.data());
+        RenderStats::countDraw();
+    }
+
+    glPopClientAttrib();
+    glPopAttrib();
+    glPopMatrix();
+}
+
+void SphereMesh::reportMemory(MemoryReport& report)
+{
+    MemoryUsage geometry;
+    size_t gpuBytes = 0;
+    for(const auto& entry : cache) {
+        const SphereMesh& mesh = *entry.second;
+        geometry += vectorMemory(mesh.vertices);
+        geometry += vectorMemory(mesh.indices);
+        gpuBytes += mesh.gpuBuffers.size()
+                  * (mesh.vertices.size() * sizeof(glm::vec3) + mesh.indices.size() * sizeof(GLuint));
+    }
+    report.add("sphere_mesh.geometry", geometry);
+    report.add("gpu.sphere_mesh.buffers", gpuMemory(gpuBytes));
+}
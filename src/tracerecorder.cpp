@@ -0,0 +1,178 @@
+#include "tracerecorder.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+static size_t roundUpToPowerOfTwo(size_t value)
+{
+    size_t result = 1;
+    while(result < value) result <<= 1;
+    return result;
+}
+
+// JSON 字符串转义，事件名一般不含特殊字符
+static void appendEscaped(std::string& out, const char* text)
+{
+    for(const char* c = text; *c; ++c) {
+        if(*c == '"' || *c == '\\') {
+            out += '\\';
+            out += *c;
+        } else if(static_cast<unsigned char>(*c) < 0x20) {
+            out += ' ';
+        } else {
+            out += *c;
+        }
+    }
+}
+
+TraceRecorder::TraceRecorder(size_t capacity)
+    : slots(new Slot[roundUpToPowerOfTwo(std::max<size_t>(capacity, 2))])
+    , mask(roundUpToPowerOfTwo(std::max<size_t>(capacity, 2)) - 1)
+    , head(0)
+    , enabled(true)
+{
+}
+
+TraceRecorder& TraceRecorder::instance()
+{
+    static TraceRecorder recorder;
+    return recorder;
+}
+
+uint64_t TraceRecorder::now()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// 当前线程的编号，0 表示尚未分配
+static thread_local uint32_t traceThreadId = 0;
+
+uint32_t TraceRecorder::currentThreadId()
+{
+    // 按首次记录的顺序给线程编号，比系统线程号更易读
+    static std::atomic<uint32_t> nextId(1);
+    if(traceThreadId == 0) traceThreadId = nextId.fetch_add(1, std::memory_order_relaxed);
+    return traceThreadId;
+}
+
+void TraceRecorder::record(const char* category, const char* name, uint64_t start, uint64_t end)
+{
+    uint64_t index = head.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = slots[index & mask];
+
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.category.store(category, std::memory_order_relaxed);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start.store(start, std::memory_order_relaxed);
+    slot.end.store(end, std::memory_order_relaxed);
+    slot.thread.store(currentThreadId(), std::memory_order_relaxed);
+    slot.sequence.store(index + 1, std::memory_order_release);
+}
+
+void TraceRecorder::setThreadName(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(threadNamesMutex);
+    // 同名线程沿用已有的编号：每局重新创建的后台线程落在同一条时间线上，名称列表也不会增长
+    for(const auto& entry : threadNames) {
+        if(entry.second == name) {
+            traceThreadId = entry.first;
+            return;
+        }
+    }
+    uint32_t id = currentThreadId();
+    for(auto& entry : threadNames) {
+        if(entry.first == id) {
+            entry.second = name;
+            return;
+        }
+    }
+    threadNames.emplace_back(id, name);
+}
+
+std::string TraceRecorder::toJson(double lastSeconds) const
+{
+    struct Event {
+        const char* category;
+        const char* name;
+        uint64_t start;
+        uint64_t end;
+        uint32_t thread;
+    };
+
+    // 复制一份快照，读取期间被覆盖或尚未写完的槽位跳过
+    const uint64_t end = head.load(std::memory_order_acquire);
+    const uint64_t begin = end > mask + 1 ? end - (mask + 1) : 0;
+    const uint64_t current = now();
+    const double window = std::max(lastSeconds, 0.0) * 1e9;
+    const uint64_t cutoff = window < static_cast<double>(current) ? current - static_cast<uint64_t>(window) : 0;
+    std::vector<Event> events;
+    events.reserve(static_cast<size_t>(end - begin));
+    for(uint64_t index = begin; index < end; ++index) {
+        const Slot& slot = slots[index & mask];
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if(sequence != index + 1) continue;
+
+        Event event;
+        event.category = slot.category.load(std::memory_order_relaxed);
+        event.name = slot.name.load(std::memory_order_relaxed);
+        event.start = slot.start.load(std::memory_order_relaxed);
+        event.end = slot.end.load(std::memory_order_relaxed);
+        event.thread = slot.thread.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if(slot.sequence.load(std::memory_order_relaxed) != sequence) continue;
+
+        if(event.end >= cutoff) events.push_back(event);
+    }
+
+    // 时间戳以导出窗口内最早的事件为零点，单位微秒
+    uint64_t origin = UINT64_MAX;
+    for(const Event& event : events) {
+        origin = std::min(origin, event.start);
+    }
+
+    std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    char number[96];
+    {
+        std::lock_guard<std::mutex> lock(threadNamesMutex);
+        for(const auto& entry : threadNames) {
+            std::snprintf(number, sizeof(number), "%s\n{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":\"",
+                          first ? "" : ",", entry.first);
+            json += number;
+            appendEscaped(json, entry.second.c_str());
+            json += "\"}}";
+            first = false;
+        }
+    }
+    for(const Event& event : events) {
+        json += first ? "\n{\"ph\":\"X\",\"pid\":1,\"cat\":\"" : ",\n{\"ph\":\"X\",\"pid\":1,\"cat\":\"";
+        appendEscaped(json, event.category);
+        json += "\",\"name\":\"";
+        appendEscaped(json, event.name);
+        std::snprintf(number, sizeof(number), "\",\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                      event.thread, (event.start - origin) / 1e3, (event.end - event.start) / 1e3);
+        json += number;
+        first = false;
+    }
+    json += "\n]}\n";
+    return json;
+}
+
+bool TraceRecorder::writeJson(const std::string& path, double lastSeconds) const
+{
+    std::ofstream file(path, std::ios::trunc);
+    if(!file) return false;
+    file << toJson(lastSeconds);
+    return static_cast<bool>(file);
+}
+
+MemoryUsage TraceRecorder::memoryUsage() const
+{
+    MemoryUsage usage;
+    usage.capacity = (mask + 1) * sizeof(Slot);
+    usage.size = std::min<uint64_t>(head.load(std::memory_order_relaxed), mask + 1) * sizeof(Slot);
+    return usage;
+}
@@ -7,6 +7,9 @@
 #include <QStyleOption>
 #include <QPainter>
 #include <GL/glew.h>
+#include "obstaclerenderer.h"
+#include "spheremesh.h"
+#include "tracerecorder.h"
 
 // MenuWidget 实现
 MenuWidget::MenuWidget(QWidget *parent) 
@@ -185,8 +188,35 @@ GameHUD::GameHUD(QWidget* parent)
     pauseResumeButton->setStyleSheet(buttonStyle);
     restartButton->setStyleSheet(buttonStyle);
     
-    // 创建主布局
-    QHBoxLayout* mainLayout = new QHBoxLayout(this);
+    // 性能统计面板，默认隐藏
+    profilerLabel = new QLabel(this);
+    QFont profilerFont("Consolas", 9);
+    profilerFont.setStyleHint(QFont::Monospace);
+    profilerLabel->setFont(profilerFont);
+    profilerLabel->setStyleSheet(
+        "color: #A5FFA5;"
+        "background: rgba(0, 0, 0, 0.6);"
+        "padding: 5px 10px;"
+        "border-radius: 5px;"
+    );
+    profilerLabel->setAlignment(Qt::AlignLeft | Qt::AlignTop);
+    profilerLabel->setSizePolicy(QSizePolicy::Maximum, QSizePolicy::Expanding);
+    profilerLabel->hide();
+    
+    // 内存统计面板，与性能统计相同的样式
+    memoryLabel = new QLabel(this);
+    memoryLabel->setFont(profilerFont);
+    memoryLabel->setStyleSheet(profilerLabel->styleSheet());
+    memoryLabel->setAlignment(Qt::AlignLeft | Qt::AlignTop);
+    memoryLabel->setSizePolicy(QSizePolicy::Maximum, QSizePolicy::Expanding);
+    memoryLabel->hide();
+    
+    // 创建主布局：上方为长度和按钮，下方为性能统计
+    QVBoxLayout* rootLayout = new QVBoxLayout(this);
+    rootLayout->setContentsMargins(0, 0, 0, 0);
+    rootLayout->setSpacing(0);
+    
+    QHBoxLayout* mainLayout = new QHBoxLayout;
     mainLayout->setContentsMargins(10, 10, 10, 10);
     
     // 左侧放置长度标签
@@ -202,7 +232,10 @@ GameHUD::GameHUD(QWidget* parent)
     buttonLayout->addWidget(restartButton);
     mainLayout->addLayout(buttonLayout);
     
-    setLayout(mainLayout);
+    rootLayout->addLayout(mainLayout);
+    rootLayout->addWidget(profilerLabel, 0, Qt::AlignLeft);
+    rootLayout->addWidget(memoryLabel, 0, Qt::AlignLeft);
+    setLayout(rootLayout);
     
     // 修复暂停/继续按钮的逻辑
     connect(pauseResumeButton, &QPushButton::clicked, [this]() {
@@ -218,10 +251,29 @@ void GameHUD::updateLength(int length) {
     lengthLabel->setText(QString("长度: %1").arg(length));
 }
 
+void GameHUD::setProfilerVisible(bool visible) {
+    profilerLabel->setVisible(visible);
+    if(!visible) profilerLabel->clear();
+}
+
+void GameHUD::setProfilerText(const QString& text) {
+    profilerLabel->setText(text);
+}
+
+void GameHUD::setMemoryVisible(bool visible) {
+    memoryLabel->setVisible(visible);
+    if(!visible) memoryLabel->clear();
+}
+
+void GameHUD::setMemoryText(const QString& text) {
+    memoryLabel->setText(text);
+}
+
 // UIManager 实现
 UIManager::UIManager(QWidget* parent)
     : QStackedWidget(parent)
     , musicManager(new MusicManager(this))
+    , memoryTimer(new QTimer(this))
 {
     // 创建并添加菜单界面
     menuWidget = new MenuWidget(this);
@@ -233,14 +285,30 @@ UIManager::UIManager(QWidget* parent)
     
     // 创建游戏HUD
     gameHUD = new GameHUD(this);
-    gameHUD->setGeometry(10, 10, width() - 20, 50);  // 减小高度，只占用顶部
     gameHUD->hide();
+    updateHUDGeometry();
     
     // 连接信号
     connect(menuWidget, &MenuWidget::startGameClicked, this, &UIManager::startGame);
     connect(gameHUD, &GameHUD::pauseResumeClicked, this, &UIManager::pauseResumeGame);
     connect(gameHUD, &GameHUD::restartClicked, this, &UIManager::restartGame);
     connect(gameWidget, &GameWidget::lengthChanged, gameHUD, &GameHUD::updateLength);
+    connect(gameWidget, &GameWidget::profilerReport, gameHUD, &GameHUD::setProfilerText);
+    connect(gameWidget, &GameWidget::profilerToggled, this, [this](bool enabled) {
+        gameHUD->setProfilerVisible(enabled);
+        updateHUDGeometry();
+    });
+    connect(memoryTimer, &QTimer::timeout, this, &UIManager::updateMemoryOverlay);
+    connect(gameWidget, &GameWidget::memoryOverlayToggled, this, [this](bool enabled) {
+        gameHUD->setMemoryVisible(enabled);
+        if (enabled) {
+            updateMemoryOverlay();
+            memoryTimer->start(MEMORY_REPORT_INTERVAL);
+        } else {
+            memoryTimer->stop();
+        }
+        updateHUDGeometry();
+    });
     
     // 显示菜单并播放菜单音乐
     setCurrentWidget(menuWidget);
@@ -251,10 +319,43 @@ void UIManager::resizeEvent(QResizeEvent* event)
 {
     QStackedWidget::resizeEvent(event);
     if (gameHUD) {
-        gameHUD->setGeometry(10, 10, width() - 20, 50);  // 保持在顶部，固定高度
+        updateHUDGeometry();
     }
 }
 
+void UIManager::updateHUDGeometry()
+{
+    // 保持在顶部，显示性能统计时向下延伸
+    int height = GameHUD::BAR_HEIGHT;
+    if (gameHUD->isProfilerVisible()) {
+        height += GameHUD::PROFILER_HEIGHT;
+    }
+    if (gameHUD->isMemoryVisible()) {
+        height += GameHUD::MEMORY_HEIGHT;
+    }
+    gameHUD->setGeometry(10, 10, width() - 20, height);
+}
+
+MemoryReport UIManager::collectMemoryReport() const
+{
+    MemoryReport report;
+    gameWidget->reportMemory(report);
+    if (menuWidget->getGameWidget()) {
+        MemoryReport menuReport;
+        menuWidget->getGameWidget()->reportMemory(menuReport);
+        report.append("menu.", menuReport);
+    }
+    ObstacleRenderer::reportMemory(report);
+    SphereMesh::reportMemory(report);
+    report.add("trace.ring", TraceRecorder::instance().memoryUsage());
+    return report;
+}
+
+void UIManager::updateMemoryOverlay()
+{
+    gameHUD->setMemoryText(QString::fromStdString(collectMemoryReport().toText()));
+}
+
 void UIManager::startGame()
 {
     setCurrentWidget(gameWidget);
@@ -1,6 +1,9 @@
 #define GLM_ENABLE_EXPERIMENTAL
 #include "water.h"
 #include <QDebug>
+#include "logging.h"
+#include "renderstats.h"
+#include "tracerecorder.h"
 #include <glm/gtx/vector_angle.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <algorithm>  // 为 std::clamp 添加头文件
@@ -297,6 +300,31 @@ Water::~Water() {
     if(volumetricVBO) glDeleteBuffers(1, &volumetricVBO);
 }
 
+void Water::setSeed(uint64_t seed) {
+    particleRng.seed(seed, static_cast<uint64_t>(RngStream::WATER_PARTICLES));
+    underwaterRng.seed(seed, static_cast<uint64_t>(RngStream::UNDERWATER_PARTICLES));
+    bubbleRng.seed(seed, static_cast<uint64_t>(RngStream::BUBBLES));
+    causticRng.seed(seed, static_cast<uint64_t>(RngStream::CAUSTICS));
+}
+
+void Water::reportMemory(MemoryReport& report) const {
+    report.add("water.bubbles", vectorMemory(bubbles));
+    MemoryUsage particles = vectorMemory(waterParticles);
+    particles += vectorMemory(particleJitter);
+    report.add("water.particles", particles);
+    report.add("water.underwater_particles", vectorMemory(underwaterParticles));
+    for(const auto& allocation : gpuAllocations) {
+        report.add("gpu.water." + allocation.first, gpuMemory(allocation.second));
+    }
+}
+
+void Water::setMaxWaterParticles(int count) {
+    maxWaterParticles = static_cast<size_t>(std::max(count, 0));
+    if(waterParticles.size() > maxWaterParticles) {
+        waterParticles.resize(maxWaterParticles);
+    }
+}
+
 void Water::initializeGL()
 {
     initializeOpenGLFunctions();
@@ -304,46 +332,47 @@ void Water::initializeGL()
 
 // 修改init函数，确保气泡正确初始化
 void Water::init() {
-    qDebug() << "\n=== Initializing Water System ===";
-    qDebug() << "Water size:" << size;
-    qDebug() << "MAX_BUBBLES:" << MAX_BUBBLES;
+    AQ_TRACE_SCOPE("asset", "Water::init");
+    AQ_DEBUG(lcWater) << "\n=== Initializing Water System ===";
+    AQ_DEBUG(lcWater) << "Water size:" << size;
+    AQ_DEBUG(lcWater) << "MAX_BUBBLES:" << MAX_BUBBLES;
     
     // 初始化OpenGL函数
     initializeOpenGLFunctions();
     
     // 检查必要的OpenGL扩展
-    qDebug() << "Checking OpenGL extensions...";
+    AQ_DEBUG(lcWater) << "Checking OpenGL extensions...";
     if (!glewIsSupported("GL_ARB_point_sprite")) {
-        qDebug() << "Warning: GL_ARB_point_sprite not supported!";
+        AQ_WARNING(lcWater) << "Warning: GL_ARB_point_sprite not supported!";
     }
     if (!glewIsSupported("GL_ARB_point_parameters")) {
-        qDebug() << "Warning: GL_ARB_point_parameters not supported!";
+        AQ_WARNING(lcWater) << "Warning: GL_ARB_point_parameters not supported!";
     }
     
     // 获取OpenGL版本信息
     const GLubyte* version = glGetString(GL_VERSION);
     const GLubyte* vendor = glGetString(GL_VENDOR);
     const GLubyte* renderer = glGetString(GL_RENDERER);
-    qDebug() << "OpenGL Version:" << version;
-    qDebug() << "OpenGL Vendor:" << vendor;
-    qDebug() << "OpenGL Renderer:" << renderer;
+    AQ_DEBUG(lcWater) << "OpenGL Version:" << version;
+    AQ_DEBUG(lcWater) << "OpenGL Vendor:" << vendor;
+    AQ_DEBUG(lcWater) << "OpenGL Renderer:" << renderer;
     
     // 初始化着色器
-    qDebug() << "\nInitializing shaders...";
+    AQ_DEBUG(lcWater) << "\nInitializing shaders...";
     initShaders();
     if (!validateShaderProgram()) {
-        qDebug() << "Shader initialization failed!";
+        AQ_WARNING(lcWater) << "Shader initialization failed!";
         return;
     }
-    qDebug() << "Shader initialization successful";
+    AQ_DEBUG(lcWater) << "Shader initialization successful";
     
     // 创建几何体
-    qDebug() << "\nCreating water surface...";
+    AQ_DEBUG(lcWater) << "\nCreating water surface...";
     createWaterSurface();
-    qDebug() << "Water surface created with" << vertexCount << "vertices";
+    AQ_DEBUG(lcWater) << "Water surface created with" << vertexCount << "vertices";
     
     // 初始化纹理
-    qDebug() << "\nInitializing textures...";
+    AQ_DEBUG(lcWater) << "\nInitializing textures...";
     
     // 删除所有现有纹理
     if(causticTexture != 0) glDeleteTextures(1, &causticTexture);
@@ -366,15 +395,15 @@ void Water::init() {
     glGenTextures(1, &waterParticleTexture);
     
     // 检查纹理创建是否成功
-    qDebug() << "Texture IDs:";
-    qDebug() << "- Caustic texture:" << causticTexture;
-    qDebug() << "- Water normal texture:" << waterNormalTexture;
-    qDebug() << "- Bubble texture:" << bubbleTexture;
-    qDebug() << "- Volumetric light texture:" << volumetricLightTexture;
-    qDebug() << "- Water particle texture:" << waterParticleTexture;
+    AQ_DEBUG(lcWater) << "Texture IDs:";
+    AQ_DEBUG(lcWater) << "- Caustic texture:" << causticTexture;
+    AQ_DEBUG(lcWater) << "- Water normal texture:" << waterNormalTexture;
+    AQ_DEBUG(lcWater) << "- Bubble texture:" << bubbleTexture;
+    AQ_DEBUG(lcWater) << "- Volumetric light texture:" << volumetricLightTexture;
+    AQ_DEBUG(lcWater) << "- Water particle texture:" << waterParticleTexture;
     
     // 初始化各个组件
-    qDebug() << "\nInitializing components...";
+    AQ_DEBUG(lcWater) << "\nInitializing components...";
     initCausticTexture();
     initWaterNormalTexture();
     createBubbleTexture();
@@ -384,130 +413,131 @@ void Water::init() {
     // 验证纹理创建
     bool texturesValid = true;
     if(!glIsTexture(causticTexture)) {
-        qDebug() << "Error: Caustic texture not valid!";
+        AQ_WARNING(lcWater) << "Error: Caustic texture not valid!";
         texturesValid = false;
     }
     if(!glIsTexture(waterNormalTexture)) {
-        qDebug() << "Error: Water normal texture not valid!";
+        AQ_WARNING(lcWater) << "Error: Water normal texture not valid!";
         texturesValid = false;
     }
     if(!glIsTexture(bubbleTexture)) {
-        qDebug() << "Error: Bubble texture not valid!";
+        AQ_WARNING(lcWater) << "Error: Bubble texture not valid!";
         texturesValid = false;
     }
     if(!glIsTexture(volumetricLightTexture)) {
-        qDebug() << "Error: Volumetric light texture not valid!";
+        AQ_WARNING(lcWater) << "Error: Volumetric light texture not valid!";
         texturesValid = false;
     }
     if(!glIsTexture(waterParticleTexture)) {
-        qDebug() << "Error: Water particle texture not valid!";
+        AQ_WARNING(lcWater) << "Error: Water particle texture not valid!";
         texturesValid = false;
     }
     
     if(!texturesValid) {
-        qDebug() << "One or more textures failed to initialize!";
+        AQ_WARNING(lcWater) << "One or more textures failed to initialize!";
         return;
     }
     
-    qDebug() << "All textures initialized successfully";
+    AQ_DEBUG(lcWater) << "All textures initialized successfully";
     
     // 初始化粒子系统
-    qDebug() << "\nInitializing particle system...";
+    AQ_DEBUG(lcWater) << "\nInitializing particle system...";
     initParticleSystem();
     
     // 初始化水效果
-    qDebug() << "\nInitializing underwater effects...";
+    AQ_DEBUG(lcWater) << "\nInitializing underwater effects...";
     initUnderwaterEffects();
     
     // 确保水下粒子系统正确初始化
-    qDebug() << "\nInitializing underwater particles...";
+    AQ_DEBUG(lcWater) << "\nInitializing underwater particles...";
     underwaterParticles.resize(static_cast<size_t>(waterParams.underwaterParticleDensity));
     for(auto& particle : underwaterParticles) {
         generateUnderwaterParticle(particle);
     }
-    qDebug() << "Underwater particles initialized:" << underwaterParticles.size();
+    AQ_DEBUG(lcWater) << "Underwater particles initialized:" << underwaterParticles.size();
     
     // 生成初始气泡
-    qDebug() << "\nGenerating initial bubbles...";
+    AQ_DEBUG(lcWater) << "\nGenerating initial bubbles...";
     bubbles.clear();  // 确保从空列表开始
     for(int i = 0; i < MAX_BUBBLES; ++i) {
         spawnBubble();
         if(i % 100 == 0) {
-            qDebug() << "Generated" << i + 1 << "bubbles...";
+            AQ_DEBUG(lcWater) << "Generated" << i + 1 << "bubbles...";
         }
     }
     
     // 验证初始化状态
-    qDebug() << "\nInitialization complete:";
-    qDebug() << "- Bubbles:" << bubbles.size() << "/" << MAX_BUBBLES;
-    qDebug() << "- Water particles:" << waterParticles.size();
-    qDebug() << "- Underwater particles:" << underwaterParticles.size();
+    AQ_DEBUG(lcWater) << "\nInitialization complete:";
+    AQ_DEBUG(lcWater) << "- Bubbles:" << bubbles.size() << "/" << MAX_BUBBLES;
+    AQ_DEBUG(lcWater) << "- Water particles:" << waterParticles.size();
+    AQ_DEBUG(lcWater) << "- Underwater particles:" << underwaterParticles.size();
     
     if(bubbles.empty()) {
-        qDebug() << "Warning: No bubbles were generated!";
+        AQ_WARNING(lcWater) << "Warning: No bubbles were generated!";
     } else {
         const auto& firstBubble = bubbles[0];
-        qDebug() << "First bubble state:";
-        qDebug() << "- Position:" << firstBubble.position.x << firstBubble.position.y << firstBubble.position.z;
-        qDebug() << "- Size:" << firstBubble.size;
-        qDebug() << "- Speed:" << firstBubble.speed;
+        AQ_DEBUG(lcWater) << "First bubble state:";
+        AQ_DEBUG(lcWater) << "- Position:" << firstBubble.position.x << firstBubble.position.y << firstBubble.position.z;
+        AQ_DEBUG(lcWater) << "- Size:" << firstBubble.size;
+        AQ_DEBUG(lcWater) << "- Speed:" << firstBubble.speed;
     }
     
     // 检查OpenGL错误
     GLenum error = glGetError();
     if(error != GL_NO_ERROR) {
-        qDebug() << "OpenGL error after initialization:" << error;
+        AQ_WARNING(lcWater) << "OpenGL error after initialization:" << error;
     } else {
-        qDebug() << "No OpenGL errors during initialization";
+        AQ_DEBUG(lcWater) << "No OpenGL errors during initialization";
     }
 }
 
 void Water::initParticleSystem() {
-    qDebug() << "\n=== Initializing Particle System ===";
+    AQ_DEBUG(lcWater) << "\n=== Initializing Particle System ===";
     
     // 清空并重新生成气泡
     bubbles.clear();
     bubbleSpawnTimer = 0.0f;
     
-    qDebug() << "Generating initial bubbles...";
-    qDebug() << "MAX_BUBBLES:" << MAX_BUBBLES;
+    AQ_DEBUG(lcWater) << "Generating initial bubbles...";
+    AQ_DEBUG(lcWater) << "MAX_BUBBLES:" << MAX_BUBBLES;
     
     // 初始生成一定数量的气泡
     for(int i = 0; i < MAX_BUBBLES; ++i) {
         spawnBubble();
         if(i == 0 || i == MAX_BUBBLES-1) {
-            qDebug() << "Generated bubble" << i + 1 << "of" << MAX_BUBBLES;
+            AQ_DEBUG(lcWater) << "Generated bubble" << i + 1 << "of" << MAX_BUBBLES;
         }
     }
     
-    qDebug() << "Initialization complete. Total bubbles:" << bubbles.size();
+    AQ_DEBUG(lcWater) << "Initialization complete. Total bubbles:" << bubbles.size();
     
     // 验证气泡是否正确生成
     if(!bubbles.empty()) {
         const auto& firstBubble = bubbles[0];
-        qDebug() << "First bubble verification:";
-        qDebug() << "- Position:" << firstBubble.position.x << firstBubble.position.y << firstBubble.position.z;
-        qDebug() << "- Size:" << firstBubble.size;
-        qDebug() << "- Speed:" << firstBubble.speed;
-        qDebug() << "- Alpha:" << firstBubble.alpha;
+        AQ_DEBUG(lcWater) << "First bubble verification:";
+        AQ_DEBUG(lcWater) << "- Position:" << firstBubble.position.x << firstBubble.position.y << firstBubble.position.z;
+        AQ_DEBUG(lcWater) << "- Size:" << firstBubble.size;
+        AQ_DEBUG(lcWater) << "- Speed:" << firstBubble.speed;
+        AQ_DEBUG(lcWater) << "- Alpha:" << firstBubble.alpha;
     } else {
-        qDebug() << "Error: No bubbles were generated!";
+        AQ_WARNING(lcWater) << "Error: No bubbles were generated!";
     }
     
     // 检查气泡纹理
     if(bubbleTexture == 0) {
-        qDebug() << "Creating bubble texture...";
+        AQ_DEBUG(lcWater) << "Creating bubble texture...";
         createBubbleTexture();
     }
     
     if(!glIsTexture(bubbleTexture)) {
-        qDebug() << "Error: Bubble texture not created properly!";
+        AQ_WARNING(lcWater) << "Error: Bubble texture not created properly!";
     } else {
-        qDebug() << "Bubble texture created successfully.";
+        AQ_DEBUG(lcWater) << "Bubble texture created successfully.";
     }
 }
 
 void Water::initUnderwaterEffects() {
+    AQ_TRACE_SCOPE("texture", "Water::initUnderwaterEffects");
     // 创建水下粒子纹理
     const int texSize = 32;
     std::vector<unsigned char> texData(texSize * texSize * 4);
@@ -532,6 +562,7 @@ void Water::initUnderwaterEffects() {
     glGenTextures(1, &underwaterParticleTexture);
     glBindTexture(GL_TEXTURE_2D, underwaterParticleTexture);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, texSize, texSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, texData.data());
+    trackGpuMemory("underwater_particle_texture", textureBytes(texSize, texSize, 4));
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     
@@ -543,6 +574,7 @@ void Water::initUnderwaterEffects() {
 }
 
 void Water::initShaders() {
+    AQ_TRACE_SCOPE("shader", "Water::initShaders");
     // 创建并编译着色器
     GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
     GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
@@ -557,7 +589,7 @@ void Water::initShaders() {
     glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
     if(!success) {
         glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        qDebug() << "Vertex shader compilation failed:\n" << infoLog;
+        AQ_WARNING(lcWater) << "Vertex shader compilation failed:\n" << infoLog;
     }
     
     // 编译片段着色器
@@ -565,7 +597,7 @@ void Water::initShaders() {
     glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
     if(!success) {
         glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        qDebug() << "Fragment shader compilation failed:\n" << infoLog;
+        AQ_WARNING(lcWater) << "Fragment shader compilation failed:\n" << infoLog;
         return;  // 如果着色器编译失败，立即返回
     }
     
@@ -579,7 +611,7 @@ void Water::initShaders() {
     glGetProgramiv(waterProgram, GL_LINK_STATUS, &success);
     if(!success) {
         glGetProgramInfoLog(waterProgram, 512, NULL, infoLog);
-        qDebug() << "Shader program linking failed:\n" << infoLog;
+        AQ_WARNING(lcWater) << "Shader program linking failed:\n" << infoLog;
         return;  // 如果链接失败，立即返回
     }
     
@@ -597,7 +629,7 @@ void Water::initShaders() {
     for(const char* uniform : requiredUniforms) {
         uniformLocation = glGetUniformLocation(waterProgram, uniform);
         if(uniformLocation == -1) {
-            qDebug() << "Warning: Uniform" << uniform << "not found in shader program";
+            AQ_WARNING(lcWater) << "Warning: Uniform" << uniform << "not found in shader program";
         }
     }
 }
@@ -624,6 +656,7 @@ void Water::createWaterSurface() {
     glBindVertexArray(waterVAO);
     glBindBuffer(GL_ARRAY_BUFFER, waterVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    trackGpuMemory("surface_vbo", sizeof(vertices));
 
     // 位置属性
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
@@ -636,6 +669,7 @@ void Water::createWaterSurface() {
 }
 
 void Water::initCausticTexture() {
+    AQ_TRACE_SCOPE("texture", "Water::initCausticTexture");
     // 确保纹理已创建
     if (causticTexture == 0) {
         glGenTextures(1, &causticTexture);
@@ -652,17 +686,42 @@ void Water::initCausticTexture() {
     const int texSize = 512;
     std::vector<float> texData(texSize * texSize, 0.0f);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, texSize, texSize, 0, GL_RED, GL_FLOAT, texData.data());
+    trackGpuMemory("caustic_texture", textureBytes(texSize, texSize, 4));
     
     // 验证纹理创建
     if (!glIsTexture(causticTexture)) {
-        qDebug() << "Failed to create caustic texture!";
+        AQ_WARNING(lcWater) << "Failed to create caustic texture!";
     }
     
     glBindTexture(GL_TEXTURE_2D, 0);
 }
 
 void Water::generateCausticTexture() {
-    const int texSize = 512; // 增加纹理分率
+    AQ_TRACE_SCOPE("texture", "Water::generateCausticTexture");
+    const int texSize = CAUSTIC_TEXTURE_SIZE; // 增加纹理分率
+    std::vector<float> texData = buildCausticTexture(texSize);
+    
+    // 更新纹理
+    glBindTexture(GL_TEXTURE_2D, causticTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, texSize, texSize, 0, GL_RED, GL_FLOAT, texData.data());
+    trackGpuMemory("caustic_texture", textureBytes(texSize, texSize, 4, true));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    // 添加纹理状态检查
+    GLint width, height;
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+    
+    if(width == 0 || height == 0) {
+        AQ_WARNING(lcWater) << "Warning: Invalid caustic texture dimensions";
+    }
+}
+
+std::vector<float> Water::buildCausticTexture(int texSize) {
     std::vector<float> texData(texSize * texSize);
     
     // 生成基于Voronoi图案的焦散纹理
@@ -680,8 +739,8 @@ void Water::generateCausticTexture() {
                 float minDist = 1.0f;
                 for(int i = 0; i < 4; ++i) {
                     glm::vec2 cellPos(
-                        floor(pos.x) + float(rand()) / RAND_MAX,
-                        floor(pos.y) + float(rand()) / RAND_MAX
+                        floor(pos.x) + causticRng.nextFloat(),
+                        floor(pos.y) + causticRng.nextFloat()
                     );
                     float dist = glm::length(pos - cellPos);
                     minDist = glm::min(minDist, dist);
@@ -695,24 +754,7 @@ void Water::generateCausticTexture() {
             texData[y * texSize + x] = glm::clamp(value, 0.0f, 1.0f);
         }
     }
-    
-    // 更新纹理
-    glBindTexture(GL_TEXTURE_2D, causticTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, texSize, texSize, 0, GL_RED, GL_FLOAT, texData.data());
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glGenerateMipmap(GL_TEXTURE_2D);
-
-    // 添加纹理状态检查
-    GLint width, height;
-    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
-    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
-    
-    if(width == 0 || height == 0) {
-        qDebug() << "Warning: Invalid caustic texture dimensions";
-    }
+    return texData;
 }
 
 void Water::initVolumetricLight() {
@@ -722,6 +764,7 @@ void Water::initVolumetricLight() {
     
     glBindTexture(GL_TEXTURE_2D, volumetricLightTexture);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width(), height(), 0, GL_RGBA, GL_FLOAT, nullptr);
+    trackGpuMemory("volumetric_fbo", textureBytes(width(), height(), 8));
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     
@@ -730,7 +773,7 @@ void Water::initVolumetricLight() {
     
     // 查FBO是否完整
     if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-        qDebug() << "Volumetric light FBO is not complete!";
+        AQ_WARNING(lcWater) << "Volumetric light FBO is not complete!";
     }
     
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
@@ -739,6 +782,7 @@ void Water::initVolumetricLight() {
 }
 
 void Water::initVolumetricLightShader() {
+    AQ_TRACE_SCOPE("shader", "Water::initVolumetricLightShader");
     // 创建着色器程序
     volumetricProgram = glCreateProgram();
     
@@ -777,6 +821,7 @@ void Water::createVolumetricScreenQuad() {
     glBindVertexArray(volumetricVAO);
     glBindBuffer(GL_ARRAY_BUFFER, volumetricVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
+    trackGpuMemory("volumetric_vbo", sizeof(quadVertices));
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(1);
@@ -858,10 +903,12 @@ void Water::renderWaterSurface(const glm::mat4& projection, const glm::mat4& vie
     // 首先渲染背面
     glCullFace(GL_FRONT);
     glDrawArrays(GL_TRIANGLES, 0, vertexCount);
+    RenderStats::countDraw();
     
     // 然后渲染正面
     glCullFace(GL_BACK);
     glDrawArrays(GL_TRIANGLES, 0, vertexCount);
+    RenderStats::countDraw();
     
     glBindVertexArray(0);
     glUseProgram(0);
@@ -870,10 +917,10 @@ void Water::renderWaterSurface(const glm::mat4& projection, const glm::mat4& vie
     glDepthMask(GL_TRUE);
     
     // 调试输出
-    qDebug() << "\n=== Rendering State ===";
-    qDebug() << "Camera position:" << cameraPos.x << cameraPos.y << cameraPos.z;
-    qDebug() << "Water height:" << waterHeight;
-    qDebug() << "Is underwater:" << (cameraPos.y < waterHeight);
+    AQ_LOG_RATE_LIMITED(DEBUG, lcWater, 1000) << "Rendering state - camera:"
+        << cameraPos.x << cameraPos.y << cameraPos.z
+        << "water height:" << waterHeight
+        << "underwater:" << (cameraPos.y < waterHeight);
 }
 
 void Water::renderUnderwaterEffects(const glm::mat4& projection, const glm::mat4& view) {
@@ -903,6 +950,7 @@ void Water::renderUnderwaterEffects(const glm::mat4& projection, const glm::mat4
     // 渲染体积光
     glBindVertexArray(volumetricVAO);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    RenderStats::countDraw();
     
     // 2. 渲染焦散效果
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
@@ -920,6 +968,7 @@ void Water::renderUnderwaterEffects(const glm::mat4& projection, const glm::mat4
     glTexCoord2f(1.0f, 1.0f); glVertex3f( size, -size,  size);
     glTexCoord2f(0.0f, 1.0f); glVertex3f(-size, -size,  size);
     glEnd();
+    RenderStats::countDraw();
     
     // 3. 应用水下色调和雾效果
     glEnable(GL_FOG);
@@ -947,7 +996,7 @@ void Water::renderUnderwaterEffects(const glm::mat4& projection, const glm::mat4
 void Water::updateUnderwaterParticles(float deltaTime) {
     // 添加粒子数量检查
     if(underwaterParticles.size() != waterParams.underwaterParticleDensity) {
-        qDebug() << "Particle count mismatch. Expected:" 
+        AQ_LOG_RATE_LIMITED(WARNING, lcParticles, 1000) << "Particle count mismatch. Expected:" 
                  << waterParams.underwaterParticleDensity 
                  << "Actual:" << underwaterParticles.size();
     }
@@ -965,21 +1014,21 @@ void Water::updateUnderwaterParticles(float deltaTime) {
 void Water::generateUnderwaterParticle(UnderwaterParticle& particle) {
     float range = size * 0.8f;
     particle.position = glm::vec3(
-        (float(rand()) / RAND_MAX * 2.0f - 1.0f) * range,
-        -range + float(rand()) / RAND_MAX * range * 2.0f,
-        (float(rand()) / RAND_MAX * 2.0f - 1.0f) * range
+        underwaterRng.signedUnit() * range,
+        underwaterRng.uniform(-range, range),
+        underwaterRng.signedUnit() * range
     );
     
     // 给予慢的随机运动
     particle.velocity = glm::vec3(
-        (float(rand()) / RAND_MAX - 0.5f) * 2.0f,
-        (float(rand()) / RAND_MAX - 0.3f) * 1.0f,
-        (float(rand()) / RAND_MAX - 0.5f) * 2.0f
+        underwaterRng.signedUnit(),
+        underwaterRng.nextFloat() - 0.3f,
+        underwaterRng.signedUnit()
     ) * 10.0f;
     
     // 使用PARTICLE_MIN_SIZE和PARTICLE_MAX_SIZE来设置粒子大小
-    particle.size = PARTICLE_MIN_SIZE + float(rand()) / RAND_MAX * (PARTICLE_MAX_SIZE - PARTICLE_MIN_SIZE);
-    particle.life = PARTICLE_LIFE_MIN + float(rand()) / RAND_MAX * (PARTICLE_LIFE_MAX - PARTICLE_LIFE_MIN);
+    particle.size = underwaterRng.uniform(PARTICLE_MIN_SIZE, PARTICLE_MAX_SIZE);
+    particle.life = underwaterRng.uniform(PARTICLE_LIFE_MIN, PARTICLE_LIFE_MAX);
 }
 
 int Water::width() const {
@@ -991,7 +1040,25 @@ int Water::height() const {
 }
 
 void Water::initWaterNormalTexture() {
-    const int texSize = 256;
+    AQ_TRACE_SCOPE("texture", "Water::initWaterNormalTexture");
+    const int texSize = NORMAL_TEXTURE_SIZE;
+    std::vector<unsigned char> texData = buildWaterNormalTexture(texSize);
+    
+    // 创建并设置纹理
+    glGenTextures(1, &waterNormalTexture);
+    glBindTexture(GL_TEXTURE_2D, waterNormalTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, texSize, texSize, 0, GL_RGB, GL_UNSIGNED_BYTE, texData.data());
+    trackGpuMemory("normal_texture", textureBytes(texSize, texSize, 3, true));
+    
+    // 设置纹理参数
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glGenerateMipmap(GL_TEXTURE_2D);
+}
+
+std::vector<unsigned char> Water::buildWaterNormalTexture(int texSize) {
     std::vector<unsigned char> texData(texSize * texSize * 3);  // RGB格式
     
     // 生成Perlin噪声基的水面法线理
@@ -1047,22 +1114,12 @@ void Water::initWaterNormalTexture() {
             texData[index + 2] = static_cast<unsigned char>(normal.z * 255);
         }
     }
-    
-    // 创建并设置纹理
-    glGenTextures(1, &waterNormalTexture);
-    glBindTexture(GL_TEXTURE_2D, waterNormalTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, texSize, texSize, 0, GL_RGB, GL_UNSIGNED_BYTE, texData.data());
-    
-    // 设置纹理参数
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glGenerateMipmap(GL_TEXTURE_2D);
+    return texData;
 }
 
 void Water::createBubbleTexture() {
-    qDebug() << "\n=== Creating Bubble Texture ===";
+    AQ_TRACE_SCOPE("texture", "Water::createBubbleTexture");
+    AQ_DEBUG(lcWater) << "\n=== Creating Bubble Texture ===";
     
     // 删除旧纹理（如果存在）
     if(bubbleTexture != 0) {
@@ -1072,10 +1129,10 @@ void Water::createBubbleTexture() {
     
     // 创建新纹理
     glGenTextures(1, &bubbleTexture);
-    qDebug() << "Generated texture ID:" << bubbleTexture;
+    AQ_DEBUG(lcWater) << "Generated texture ID:" << bubbleTexture;
     
     if(bubbleTexture == 0) {
-        qDebug() << "Failed to generate texture!";
+        AQ_WARNING(lcWater) << "Failed to generate texture!";
         return;
     }
     
@@ -1121,6 +1178,7 @@ void Water::createBubbleTexture() {
     // 上传纹理数据
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, texSize, texSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, texData.data());
     checkGLError("glTexImage2D");
+    trackGpuMemory("bubble_texture", textureBytes(texSize, texSize, 4));
     
     // 设置纹理参数
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -1169,19 +1227,10 @@ void Water::updateCausticAnimation(float deltaTime) {
 
 void Water::updateBubbles(float deltaTime) {
     // 调试输出
-    static float debugTimer = 0.0f;
-    debugTimer += deltaTime;
-    if(debugTimer >= 1.0f) {
-        qDebug() << "\n=== Bubble System Status ===";
-        qDebug() << "Total bubbles:" << bubbles.size();
-        if(!bubbles.empty()) {
-            qDebug() << "First bubble:";
-            qDebug() << "- Position:" << bubbles[0].position.x << bubbles[0].position.y << bubbles[0].position.z;
-            qDebug() << "- Size:" << bubbles[0].size;
-            qDebug() << "- Speed:" << bubbles[0].speed;
-            qDebug() << "- Alpha:" << bubbles[0].alpha;
-        }
-        debugTimer = 0.0f;
+    if(!bubbles.empty()) {
+        AQ_LOG_RATE_LIMITED(DEBUG, lcBubbles, 1000) << "Bubble system - total:" << bubbles.size()
+            << "first position:" << bubbles[0].position.x << bubbles[0].position.y << bubbles[0].position.z
+            << "size:" << bubbles[0].size << "speed:" << bubbles[0].speed << "alpha:" << bubbles[0].alpha;
     }
 
     // 更新现有气泡
@@ -1225,16 +1274,14 @@ void Water::updateBubbles(float deltaTime) {
     }
 
     if(removedBubbles > 0 || spawnedBubbles > 0) {
-        qDebug() << "Bubble updates:";
-        qDebug() << "- Removed:" << removedBubbles;
-        qDebug() << "- Spawned:" << spawnedBubbles;
-        qDebug() << "- Active:" << activeBubbles;
+        AQ_LOG_RATE_LIMITED(DEBUG, lcBubbles, 1000) << "Bubble updates - removed:" << removedBubbles
+            << "spawned:" << spawnedBubbles << "active:" << activeBubbles;
     }
 }
 
 void Water::renderBubbles() {
     if(bubbles.empty()) {
-        qDebug() << "No bubbles to render!";
+        AQ_LOG_RATE_LIMITED(WARNING, lcBubbles, 1000) << "No bubbles to render!";
         return;
     }
 
@@ -1291,6 +1338,7 @@ void Water::renderBubbles() {
         glVertex3f(bubble.position.x, bubble.position.y, bubble.position.z);
     }
     glEnd();
+    RenderStats::countDraw();
     
     // 恢复OpenGL状态
     glDisable(GL_TEXTURE_2D);
@@ -1304,9 +1352,6 @@ void Water::renderBubbles() {
 }
 
 void Water::renderWaterParticles() {
-    // 调试输出
-    qDebug() << "Rendering water particles... Count:" << waterParticles.size();
-    
     // 保存当前OpenGL状态
     glPushAttrib(GL_ALL_ATTRIB_BITS);
     
@@ -1347,8 +1392,10 @@ void Water::renderWaterParticles() {
     for(const auto& particle : waterParticles) {
         if(particle.life <= 0.0f) continue;
         
+        glm::vec3 position = glm::mix(particle.previousPosition, particle.position, interpolationAlpha);
+        
         // 计算基于距离的大小衰减
-        glm::vec3 toCamera = cameraPos - particle.position;
+        glm::vec3 toCamera = cameraPos - position;
         float distanceToCamera = glm::length(toCamera);
         
         // 改进距离衰减计算
@@ -1377,16 +1424,18 @@ void Water::renderWaterParticles() {
         
         // 渲染粒子
         glVertex3f(
-            particle.position.x,
-            particle.position.y,
-            particle.position.z
+            position.x,
+            position.y,
+            position.z
         );
         
         visibleParticles++;
     }
     glEnd();
+    RenderStats::countDraw();
     
-    qDebug() << "Visible particles rendered:" << visibleParticles
+    AQ_LOG_EVERY_N(DEBUG, lcParticles, 120) << "Visible particles rendered:" << visibleParticles
+             << "of" << waterParticles.size()
              << "Is underwater:" << isUnderwater
              << "Camera Y:" << cameraPos.y
              << "Water height:" << waterHeight;
@@ -1405,15 +1454,14 @@ void Water::renderWaterParticles() {
 
 void Water::spawnBubble() {
     // 调试输出
-    qDebug() << "\n=== Spawning Bubble ===";
-    qDebug() << "Current bubble count:" << bubbles.size();
-    qDebug() << "MAX_BUBBLES:" << MAX_BUBBLES;
+    AQ_LOG_RATE_LIMITED(DEBUG, lcBubbles, 1000) << "Spawning bubble, current count:" << bubbles.size()
+        << "max:" << MAX_BUBBLES;
     
     Bubble bubble;
     
     // 在底部区域随机生成
-    float radius = std::pow(rand() / float(RAND_MAX), 2.0f) * size * 0.3f;
-    float angle = (rand() / float(RAND_MAX)) * glm::two_pi<float>();
+    float radius = std::pow(bubbleRng.nextFloat(), 2.0f) * size * 0.3f;
+    float angle = bubbleRng.nextFloat() * glm::two_pi<float>();
     
     bubble.position = glm::vec3(
         radius * cos(angle),
@@ -1423,17 +1471,17 @@ void Water::spawnBubble() {
     
     // 基础属性设置
     bubble.size = MIN_BUBBLE_SIZE + 
-                 std::pow(rand() / float(RAND_MAX), 2.0f) * (MAX_BUBBLE_SIZE - MIN_BUBBLE_SIZE);
-    bubble.speed = 15.0f + (rand() / float(RAND_MAX)) * 10.0f;
-    bubble.wobble = 0.2f + (rand() / float(RAND_MAX)) * 0.3f;
-    bubble.phase = rand() / float(RAND_MAX) * glm::two_pi<float>();
+                 std::pow(bubbleRng.nextFloat(), 2.0f) * (MAX_BUBBLE_SIZE - MIN_BUBBLE_SIZE);
+    bubble.speed = bubbleRng.uniform(15.0f, 25.0f);
+    bubble.wobble = bubbleRng.uniform(0.2f, 0.5f);
+    bubble.phase = bubbleRng.nextFloat() * glm::two_pi<float>();
     bubble.alpha = BUBBLE_BASE_ALPHA;
     
     // 新属性初始化
     bubble.deformation = 0.0f;
-    bubble.pulsePhase = rand() / float(RAND_MAX) * glm::two_pi<float>();
-    bubble.refractionIndex = 1.2f + (rand() / float(RAND_MAX)) * 0.1f;
-    bubble.highlightIntensity = 0.8f + (rand() / float(RAND_MAX)) * 0.2f;
+    bubble.pulsePhase = bubbleRng.nextFloat() * glm::two_pi<float>();
+    bubble.refractionIndex = bubbleRng.uniform(1.2f, 1.3f);
+    bubble.highlightIntensity = bubbleRng.uniform(0.8f, 1.0f);
     bubble.merging = false;
     bubble.mergeProgress = 0.0f;
     bubble.mergingWith = nullptr;
@@ -1534,13 +1582,11 @@ void Water::update(float deltaTime) {
     updateUnderwaterParticles(deltaTime);
     
     // 调试输出当前状态
-    qDebug() << "\n=== Water System Update ===";
-    qDebug() << "Water time:" << waterTime;
-    qDebug() << "Current bubble count:" << bubbles.size();
+    AQ_LOG_EVERY_N(DEBUG, lcWater, 120) << "Water update - time:" << waterTime
+        << "bubbles:" << bubbles.size();
     
     // 确保始终维持足够的气泡数量
     while(bubbles.size() < MAX_BUBBLES) {
-        qDebug() << "Spawning new bubble to maintain count";
         spawnBubble();
     }
     
@@ -1553,7 +1599,6 @@ void Water::update(float deltaTime) {
         
         // 检查气泡是否超出范围
         if(bubble.position.y > size * 0.5f) {
-            qDebug() << "Bubble reached top, removing and spawning new one";
             it = bubbles.erase(it);
             spawnBubble();  // 立即生成新气泡
         } else {
@@ -1563,9 +1608,8 @@ void Water::update(float deltaTime) {
     
     // 验证气泡数量
     if(bubbles.size() != MAX_BUBBLES) {
-        qDebug() << "Warning: Bubble count mismatch!";
-        qDebug() << "Expected:" << MAX_BUBBLES;
-        qDebug() << "Actual:" << bubbles.size();
+        AQ_LOG_RATE_LIMITED(WARNING, lcBubbles, 1000) << "Bubble count mismatch! Expected:" << MAX_BUBBLES
+            << "Actual:" << bubbles.size();
     }
     
     // 更新焦散动画
@@ -1580,20 +1624,20 @@ bool Water::validateShaderProgram() {
         glGetProgramiv(waterProgram, GL_INFO_LOG_LENGTH, &logLength);
         std::vector<char> log(logLength);
         glGetProgramInfoLog(waterProgram, logLength, nullptr, log.data());
-        qDebug() << "Shader program linking failed:" << log.data();
+        AQ_WARNING(lcWater) << "Shader program linking failed:" << log.data();
         return false;
     }
     
     // 验证uniform变量位置
     GLint loc;
     loc = glGetUniformLocation(waterProgram, "time");
-    if(loc == -1) qDebug() << "Warning: Uniform 'time' not found";
+    if(loc == -1) AQ_WARNING(lcWater) << "Warning: Uniform 'time' not found";
     
     loc = glGetUniformLocation(waterProgram, "waterDensity");
-    if(loc == -1) qDebug() << "Warning: Uniform 'waterDensity' not found";
+    if(loc == -1) AQ_WARNING(lcWater) << "Warning: Uniform 'waterDensity' not found";
     
     loc = glGetUniformLocation(waterProgram, "visibilityFalloff");
-    if(loc == -1) qDebug() << "Warning: Uniform 'visibilityFalloff' not found";
+    if(loc == -1) AQ_WARNING(lcWater) << "Warning: Uniform 'visibilityFalloff' not found";
     
     return true;
 }
@@ -1601,21 +1645,22 @@ bool Water::validateShaderProgram() {
 bool Water::checkTextureState() {
     bool success = true;
     if (glIsTexture(causticTexture) == GL_FALSE) {
-        qDebug() << "Caustic texture not valid!";
+        AQ_WARNING(lcWater) << "Caustic texture not valid!";
         success = false;
     }
     if (glIsTexture(waterNormalTexture) == GL_FALSE) {
-        qDebug() << "Water normal texture not valid!";
+        AQ_WARNING(lcWater) << "Water normal texture not valid!";
         success = false;
     }
     if (glIsTexture(bubbleTexture) == GL_FALSE) {
-        qDebug() << "Bubble texture not valid!";
+        AQ_WARNING(lcWater) << "Bubble texture not valid!";
         success = false;
     }
     return success;
 }
 
 void Water::initWaterParticles() {
+    AQ_TRACE_SCOPE("texture", "Water::initWaterParticles");
     // 创建水下颗粒纹理
     const int texSize = 256;  // 增大纹理尺寸，从64改为256
     std::vector<unsigned char> texData(texSize * texSize * 4);
@@ -1645,6 +1690,7 @@ void Water::initWaterParticles() {
     glGenTextures(1, &waterParticleTexture);
     glBindTexture(GL_TEXTURE_2D, waterParticleTexture);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, texSize, texSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, texData.data());
+    trackGpuMemory("particle_texture", textureBytes(texSize, texSize, 4, true));
     
     // 修改纹理参数
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);  // 启用mipmap
@@ -1654,20 +1700,20 @@ void Water::initWaterParticles() {
     glGenerateMipmap(GL_TEXTURE_2D);  // 生成mipmap
     
     // 初始化颗粒
-    waterParticles.resize(MAX_WATER_PARTICLES);
+    waterParticles.resize(maxWaterParticles);
     for(auto& particle : waterParticles) {
         generateWaterParticle(particle, glm::vec3(0.0f));
     }
     
-    qDebug() << "Water particle texture initialized with size:" << texSize;
-    qDebug() << "Initial particle count:" << waterParticles.size();
+    AQ_DEBUG(lcWater) << "Water particle texture initialized with size:" << texSize;
+    AQ_DEBUG(lcWater) << "Initial particle count:" << waterParticles.size();
 }
 
 void Water::generateWaterParticle(WaterParticle& particle, const glm::vec3& targetPos) {
     // 在球形空间内随机生成位置，增大生成范围
-    float theta = (rand() / float(RAND_MAX)) * glm::two_pi<float>();
-    float phi = (rand() / float(RAND_MAX)) * glm::pi<float>();
-    float radius = PARTICLE_SPAWN_RADIUS * 2.0f * std::pow(rand() / float(RAND_MAX), 0.3f);
+    float theta = particleRng.nextFloat() * glm::two_pi<float>();
+    float phi = particleRng.nextFloat() * glm::pi<float>();
+    float radius = PARTICLE_SPAWN_RADIUS * 2.0f * std::pow(particleRng.nextFloat(), 0.3f);
     
     // 使用球坐标系生成偏移
     float x = radius * sin(phi) * cos(theta);
@@ -1676,11 +1722,12 @@ void Water::generateWaterParticle(WaterParticle& particle, const glm::vec3& targ
     
     // 设置粒子位置，直接使用目标位置加上偏移
     particle.position = targetPos + glm::vec3(x, y, z);
+    particle.previousPosition = particle.position;
     
     // 调试输出
     static bool firstParticle = true;
     if(firstParticle) {
-        qDebug() << "Generating particle at:" 
+        AQ_DEBUG(lcParticles) << "Generating particle at:" 
                  << particle.position.x << particle.position.y << particle.position.z;
         firstParticle = false;
     }
@@ -1688,13 +1735,13 @@ void Water::generateWaterParticle(WaterParticle& particle, const glm::vec3& targ
     // 给予较小的随机初始速度
     float speedFactor = 0.5f;  // 增加速度
     particle.velocity = glm::vec3(
-        (rand() / float(RAND_MAX) - 0.5f) * speedFactor,
-        (rand() / float(RAND_MAX) - 0.5f) * speedFactor,
-        (rand() / float(RAND_MAX) - 0.5f) * speedFactor
+        (particleRng.nextFloat() - 0.5f) * speedFactor,
+        (particleRng.nextFloat() - 0.5f) * speedFactor,
+        (particleRng.nextFloat() - 0.5f) * speedFactor
     );
     
     // 使用指数分布生成粒子大小，使小粒子更常见
-    float randomValue = rand() / float(RAND_MAX);
+    float randomValue = particleRng.nextFloat();
     float sizeRange = PARTICLE_MAX_SIZE - PARTICLE_MIN_SIZE;
     float size = PARTICLE_MIN_SIZE + sizeRange * std::pow(randomValue, 2.5f);
     particle.size = size;
@@ -1713,13 +1760,13 @@ void Water::generateWaterParticle(WaterParticle& particle, const glm::vec3& targ
     );
     
     // 使用PARTICLE_LIFE_MIN和PARTICLE_LIFE_MAX来设置生命周期
-    particle.life = PARTICLE_LIFE_MIN + (rand() / float(RAND_MAX)) * (PARTICLE_LIFE_MAX - PARTICLE_LIFE_MIN);
+    particle.life = particleRng.uniform(PARTICLE_LIFE_MIN, PARTICLE_LIFE_MAX);
     particle.fadeState = 0.0f;
     
     // 调试输出前几个粒子的信息
     static int particleCount = 0;
     if(particleCount < 5) {
-        qDebug() << "Generated particle" << particleCount 
+        AQ_DEBUG(lcParticles) << "Generated particle" << particleCount 
                  << "size:" << particle.size
                  << "alpha:" << particle.alpha
                  << "color:" << particle.color.x << particle.color.y << particle.color.z;
@@ -1742,7 +1789,7 @@ void Water::updateWaterParticles(float deltaTime, const glm::vec3& targetPos) {
             
             if (it != waterParticles.end()) {
                 generateWaterParticle(*it, targetPos);
-            } else if (waterParticles.size() < MAX_WATER_PARTICLES) {
+            } else if (waterParticles.size() < maxWaterParticles) {
                 WaterParticle newParticle;
                 generateWaterParticle(newParticle, targetPos);
                 waterParticles.push_back(newParticle);
@@ -1750,11 +1797,17 @@ void Water::updateWaterParticles(float deltaTime, const glm::vec3& targetPos) {
         }
     }
     
+    // 一次生成本帧所有粒子的随机扰动
+    particleJitter.resize(waterParticles.size());
+    particleRng.fillUniform(particleJitter.data(), particleJitter.size(), -1.0f, 1.0f);
+    
     // 更新现有粒子
-    for(auto& particle : waterParticles) {
+    for(size_t i = 0; i < waterParticles.size(); ++i) {
+        WaterParticle& particle = waterParticles[i];
         if(particle.life <= 0.0f) continue;
         
         // 更新位置
+        particle.previousPosition = particle.position;
         particle.position += particle.velocity * deltaTime;
         
         // 使用PARTICLE_FADE_TIME进行淡入淡出
@@ -1774,17 +1827,13 @@ void Water::updateWaterParticles(float deltaTime, const glm::vec3& targetPos) {
         particle.life -= deltaTime;
         
         // 添加一些随机运动
-        particle.velocity += glm::vec3(
-            (rand() / float(RAND_MAX) - 0.5f) * 2.0f,
-            (rand() / float(RAND_MAX) - 0.5f) * 2.0f,
-            (rand() / float(RAND_MAX) - 0.5f) * 2.0f
-        ) * deltaTime;
+        particle.velocity += particleJitter[i] * deltaTime;
     }
     
-    // 调试输出活跃粒子数量
-    int activeParticles = std::count_if(waterParticles.begin(), waterParticles.end(),
-        [](const WaterParticle& p) { return p.life > 0.0f; });
-    qDebug() << "Active particles:" << activeParticles;
+    // 调试输出活跃粒子数量，计数只在实际输出时进行
+    AQ_LOG_EVERY_N(DEBUG, lcParticles, 120) << "Active particles:"
+        << std::count_if(waterParticles.begin(), waterParticles.end(),
+                         [](const WaterParticle& p) { return p.life > 0.0f; });
 }
 
 void Water::updateBubble(Bubble& bubble, float deltaTime) {
@@ -1813,9 +1862,9 @@ void Water::updateBubble(Bubble& bubble, float deltaTime) {
     // 随机扰动
     float randomFactor = 0.05f;
     glm::vec3 randomMotion(
-        ((rand() / float(RAND_MAX)) * 2.0f - 1.0f),
-        ((rand() / float(RAND_MAX)) * 2.0f - 1.0f),
-        ((rand() / float(RAND_MAX)) * 2.0f - 1.0f)
+        bubbleRng.signedUnit(),
+        bubbleRng.signedUnit(),
+        bubbleRng.signedUnit()
     );
     bubble.position += randomMotion * randomFactor * deltaTime;
     
@@ -1861,52 +1910,52 @@ void Water::updateBubble(Bubble& bubble, float deltaTime) {
 }
 
 void Water::dumpOpenGLState() {
-    qDebug() << "\n=== OpenGL State Dump ===";
+    AQ_DEBUG(lcWater) << "\n=== OpenGL State Dump ===";
     
     // 获取当前绑定的着色器程序
     GLint currentProgram;
     glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
-    qDebug() << "Current shader program:" << currentProgram;
+    AQ_DEBUG(lcWater) << "Current shader program:" << currentProgram;
     
     // 检查混合状态
     GLint blendEnabled;
     glGetIntegerv(GL_BLEND, &blendEnabled);
-    qDebug() << "Blend enabled:" << (blendEnabled == GL_TRUE);
+    AQ_DEBUG(lcWater) << "Blend enabled:" << (blendEnabled == GL_TRUE);
     
     // 检查深度测试状态
     GLint depthTestEnabled;
     glGetIntegerv(GL_DEPTH_TEST, &depthTestEnabled);
-    qDebug() << "Depth test enabled:" << (depthTestEnabled == GL_TRUE);
+    AQ_DEBUG(lcWater) << "Depth test enabled:" << (depthTestEnabled == GL_TRUE);
     
     // 检查深度写入状态
     GLint depthMask;
     glGetIntegerv(GL_DEPTH_WRITEMASK, &depthMask);
-    qDebug() << "Depth mask enabled:" << (depthMask == GL_TRUE);
+    AQ_DEBUG(lcWater) << "Depth mask enabled:" << (depthMask == GL_TRUE);
     
     // 检查当前绑定的纹理
     GLint boundTexture;
     glGetIntegerv(GL_TEXTURE_BINDING_2D, &boundTexture);
-    qDebug() << "Current bound texture:" << boundTexture;
+    AQ_DEBUG(lcWater) << "Current bound texture:" << boundTexture;
     
     // 检查视口设置
     GLint viewport[4];
     glGetIntegerv(GL_VIEWPORT, viewport);
-    qDebug() << "Viewport:" << viewport[0] << viewport[1] << viewport[2] << viewport[3];
+    AQ_DEBUG(lcWater) << "Viewport:" << viewport[0] << viewport[1] << viewport[2] << viewport[3];
     
     // 检查点大小范围
     GLfloat pointSizeRange[2];
     glGetFloatv(GL_POINT_SIZE_RANGE, pointSizeRange);
-    qDebug() << "Point size range:" << pointSizeRange[0] << "-" << pointSizeRange[1];
+    AQ_DEBUG(lcWater) << "Point size range:" << pointSizeRange[0] << "-" << pointSizeRange[1];
     
     // 检查当前点大小
     GLfloat pointSize;
     glGetFloatv(GL_POINT_SIZE, &pointSize);
-    qDebug() << "Current point size:" << pointSize;
+    AQ_DEBUG(lcWater) << "Current point size:" << pointSize;
     
     // 检查错误
     GLenum error = glGetError();
     if(error != GL_NO_ERROR) {
-        qDebug() << "OpenGL error during state dump:" << error;
+        AQ_WARNING(lcWater) << "OpenGL error during state dump:" << error;
     }
 }
 
@@ -1936,7 +1985,7 @@ void Water::checkGLError(const char* operation) {
             default:
                 errorString = QString("Unknown error %1").arg(error);
         }
-        qDebug() << "OpenGL error after" << operation << ":" << errorString;
+        AQ_WARNING(lcWater) << "OpenGL error after" << operation << ":" << errorString;
     }
 }
 